@@ -0,0 +1,193 @@
+#include "pointer/pointer.h"
+#include "structure/arena.hpp"
+#include "utils/timer.h"
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <cstdio>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// 统计堆分配次数，直接转发到 glibc 的实现
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t num, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t align, size_t size);
+}
+
+static std::atomic<long> alloc_count(0);
+static std::atomic<long> alloc_bytes(0);
+
+static inline void count_alloc(size_t size) {
+    alloc_count.fetch_add(1, std::memory_order_relaxed);
+    alloc_bytes.fetch_add((long)size, std::memory_order_relaxed);
+}
+
+extern "C" {
+void* malloc(size_t size) {
+    count_alloc(size);
+    return __libc_malloc(size);
+}
+void* calloc(size_t num, size_t size) {
+    count_alloc(num * size);
+    return __libc_calloc(num, size);
+}
+void* realloc(void* ptr, size_t size) {
+    count_alloc(size);
+    return __libc_realloc(ptr, size);
+}
+void* memalign(size_t align, size_t size) {
+    count_alloc(size);
+    return __libc_memalign(align, size);
+}
+void* aligned_alloc(size_t align, size_t size) {
+    count_alloc(size);
+    return __libc_memalign(align, size);
+}
+int posix_memalign(void** ptr, size_t align, size_t size) {
+    count_alloc(size);
+    void* p = __libc_memalign(align, size);
+    if (p == nullptr) return ENOMEM;
+    *ptr = p;
+    return 0;
+}
+}
+
+// 合成一帧：暗背景上若干对蓝色灯条
+static cv::Mat makeFrame(std::vector<rm::Armor>& armors) {
+    cv::Mat frame(1024, 1280, CV_8UC3, cv::Scalar(20, 20, 20));
+    armors.clear();
+    for (int i = 0; i < 6; i++) {
+        int x = 120 + i * 180, y = 300 + (i % 3) * 200;
+        cv::rectangle(frame, cv::Rect(x, y, 8, 40), cv::Scalar(255, 200, 120), -1);
+        cv::rectangle(frame, cv::Rect(x + 90, y, 8, 40), cv::Scalar(255, 200, 120), -1);
+
+        rm::Armor armor;
+        armor.rect = cv::Rect(x - 20, y - 20, 140, 80);
+        armor.center = cv::Point2f(x + 49, y + 20);
+        armors.push_back(armor);
+    }
+    return frame;
+}
+
+// 原流程：每帧新建临时 Mat
+static void legacyFrame(const cv::Mat& frame, const std::vector<rm::Armor>& armors) {
+    cv::Mat gray, binary, equalized;
+    rm::getGrayScale(frame, gray, rm::ARMOR_COLOR_BLUE, rm::GRAY_SCALE_METHOD_CVT);
+    rm::getBinary(gray, binary, 0.5, rm::BINARY_METHOD_MAX_MIN_RATIO);
+    rm::getHistogramEqualization(frame, equalized);
+    for (const auto& armor : armors) {
+        cv::Mat roi_gray, roi_binary;
+        rm::getGrayBinaryROI(frame, armor, roi_gray, roi_binary, 0.5);
+        rm::getArmorColorFromHSV(frame, armor.rect);
+    }
+}
+
+// 临时 Mat 全部来自 arena，帧末统一 reset
+static void arenaFrame(const cv::Mat& frame, const std::vector<rm::Armor>& armors, rm::FrameArena& arena) {
+    cv::Mat gray = rm::getGrayScale(frame, arena, rm::ARMOR_COLOR_BLUE, rm::GRAY_SCALE_METHOD_CVT);
+    cv::Mat binary = rm::getBinary(gray, arena, 0.5, rm::BINARY_METHOD_MAX_MIN_RATIO);
+    cv::Mat equalized = rm::getHistogramEqualization(frame, arena);
+    for (const auto& armor : armors) {
+        cv::Mat roi_gray, roi_binary;
+        rm::getGrayBinaryROI(frame, armor, arena, roi_gray, roi_binary, 0.5);
+        rm::getArmorColorFromHSV(frame, armor.rect, arena);
+    }
+    arena.reset();
+}
+
+// 原流程的灯条提取，返回各装甲板灯条总数
+static size_t legacyLightbars(const cv::Mat& frame, const std::vector<rm::Armor>& armors,
+                              const rm::ArmorRefineParam& param, std::vector<rm::Lightbar>& lightbars) {
+    size_t total = 0;
+    for (const auto& armor : armors) {
+        cv::Mat roi_gray, roi_binary;
+        rm::getGrayBinaryROI(frame, armor, roi_gray, roi_binary, 0.5);
+        rm::getLightbarsFromBinary(roi_binary, lightbars, param.min_rect_side, param.max_rect_side,
+                                   param.min_value_area, param.min_ratio_area, param.max_angle);
+        total += lightbars.size();
+    }
+    return total;
+}
+
+// ROI 与连通域标记来自 arena，轮廓与灯条列表仍在堆上
+static size_t arenaLightbars(const cv::Mat& frame, const std::vector<rm::Armor>& armors,
+                             const rm::ArmorRefineParam& param, std::vector<rm::Lightbar>& lightbars,
+                             rm::FrameArena& arena) {
+    size_t total = 0;
+    for (const auto& armor : armors) {
+        cv::Mat roi_gray, roi_binary;
+        rm::getGrayBinaryROI(frame, armor, arena, roi_gray, roi_binary, 0.5);
+        rm::getLightbarsFromBinary(roi_binary, arena, lightbars, param.min_rect_side, param.max_rect_side,
+                                   param.min_value_area, param.min_ratio_area, param.max_angle);
+        total += lightbars.size();
+    }
+    arena.reset();
+    return total;
+}
+
+struct Stat {
+    long count;
+    long bytes;
+    double us;
+};
+
+template <typename Func>
+static Stat measure(int loop, Func func) {
+    long count0 = alloc_count.load(), bytes0 = alloc_bytes.load();
+    TimePoint t0 = getTime();
+    for (int i = 0; i < loop; i++) func();
+    TimePoint t1 = getTime();
+    return Stat{alloc_count.load() - count0, alloc_bytes.load() - bytes0, getDoubleOfS(t0, t1) * 1e6};
+}
+
+static void printStat(const char* name, const Stat& stat, int loop) {
+    printf("%-16s %14.1f %14.1f %12.1f\n", name,
+           (double)stat.count / loop, (double)stat.bytes / loop / 1024.0, stat.us / loop);
+}
+
+// 用法：arena_bench
+int main() {
+    // 单线程统计，避免 OpenCV 工作线程的分配计入结果
+    cv::setNumThreads(1);
+
+    std::vector<rm::Armor> armors;
+    cv::Mat frame = makeFrame(armors);
+    rm::FrameArena& arena = rm::FrameArena::local();
+    rm::ArmorRefineParam param;
+    std::vector<rm::Lightbar> lightbars;
+    const int warmup = 10;
+    const int loop = 200;
+
+    size_t legacy_total = 0, arena_total = 0;
+    for (int i = 0; i < warmup; i++) {
+        legacyFrame(frame, armors);
+        arenaFrame(frame, armors, arena);
+        legacy_total = legacyLightbars(frame, armors, param, lightbars);
+        arena_total = arenaLightbars(frame, armors, param, lightbars, arena);
+    }
+
+    Stat legacy = measure(loop, [&] { legacyFrame(frame, armors); });
+    Stat arena_mat = measure(loop, [&] { arenaFrame(frame, armors, arena); });
+    Stat legacy_lightbar = measure(loop, [&] { legacyLightbars(frame, armors, param, lightbars); });
+    Stat arena_lightbar = measure(loop, [&] { arenaLightbars(frame, armors, param, lightbars, arena); });
+
+    printf("%-16s %14s %14s %12s\n", "path", "allocs/frame", "KB/frame", "us/frame");
+    printStat("legacy", legacy, loop);
+    printStat("arena", arena_mat, loop);
+    printStat("legacy lightbar", legacy_lightbar, loop);
+    printStat("arena lightbar", arena_lightbar, loop);
+    printf("lightbars %zu / %zu\n", legacy_total, arena_total);
+    printf("arena peak %.1f KB, capacity %.1f KB\n",
+           arena.getPeak() / 1024.0, arena.getCapacity() / 1024.0);
+
+    // 稳定后 Mat 流程每帧不应再有任何堆分配
+    // 灯条流程中 findContours 与灯条轮廓仍在堆上分配，只要求少于原流程且结果一致
+    bool pass = (arena_mat.count == 0) &&
+                (arena_lightbar.count < legacy_lightbar.count) &&
+                (legacy_total == arena_total) && (legacy_total > 0);
+    printf("%s\n", pass ? "pass" : "fail");
+    return pass ? 0 : 1;
+}
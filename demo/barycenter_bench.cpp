@@ -0,0 +1,62 @@
+#include "pointer/pointer.h"
+#include "utils/timer.h"
+#include <opencv2/opencv.hpp>
+#include <cstdio>
+#include <cmath>
+#include <vector>
+
+template <class Func>
+static double timeit(Func func, int loop) {
+    func();
+    TimePoint t0 = getTime();
+    for (int i = 0; i < loop; i++) func();
+    return getDoubleOfS(t0, getTime()) * 1e6 / loop;
+}
+
+static double maxDiff(const std::vector<cv::Point2f>& a, const std::vector<cv::Point2f>& b) {
+    double diff = 0;
+    for (size_t i = 0; i < a.size(); i++) diff = std::max(diff, cv::norm(a[i] - b[i]));
+    return diff;
+}
+
+int main() {
+    cv::Mat gray(480, 640, CV_8UC1);
+    cv::randu(gray, cv::Scalar::all(1), cv::Scalar::all(256));
+    cv::Mat bgr(480, 640, CV_8UC3);
+    cv::randu(bgr, cv::Scalar::all(1), cv::Scalar::all(256));
+
+    const std::vector<int> radii = {2, 4, 8, 16, 32};
+    const std::vector<int> counts = {2, 4, 32};
+    const int loop = 200;
+
+    printf("%-6s %-6s %-6s %10s %10s %10s %10s %10s\n",
+           "image", "radius", "points", "ref us", "mask us", "int us", "mask diff", "int diff");
+    for (int channel = 0; channel < 2; channel++) {
+        const cv::Mat& src = (channel == 0) ? gray : bgr;
+        for (int radius : radii) {
+            for (int count : counts) {
+                // 灯条端点一般两两成对地相距不远
+                std::vector<cv::Point> centers;
+                for (int i = 0; i < count; i++) {
+                    centers.push_back(cv::Point(200 + (i % 8) * 20, 200 + (i / 8) * 30 + (i % 2) * 12));
+                }
+
+                std::vector<cv::Point2f> ref, mask, integral;
+                double ref_us = timeit([&] {
+                    rm::getBarycenters(src, centers, radius, ref, rm::ARMOR_COLOR_BLUE, rm::BARYCENTER_METHOD_REFERENCE);
+                }, loop);
+                double mask_us = timeit([&] {
+                    rm::getBarycenters(src, centers, radius, mask, rm::ARMOR_COLOR_BLUE, rm::BARYCENTER_METHOD_MASK);
+                }, loop);
+                double int_us = timeit([&] {
+                    rm::getBarycenters(src, centers, radius, integral, rm::ARMOR_COLOR_BLUE, rm::BARYCENTER_METHOD_INTEGRAL);
+                }, loop);
+
+                printf("%-6s %-6d %-6d %10.2f %10.2f %10.2f %10.2e %10.2e\n",
+                       (channel == 0) ? "gray" : "bgr", radius, count,
+                       ref_us, mask_us, int_us, maxDiff(ref, mask), maxDiff(ref, integral));
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,55 @@
+#include <openrm/openrm.h>
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <thread>
+#include <chrono>
+using namespace std;
+
+int main() {
+    std::vector<std::string> device_list;
+    // rm::listUVC(device_list, "usb_cam_");
+    rm::listUVC(device_list, "video");
+    std::vector<rm::Camera*> cameras;
+
+    for(int i = 0; i < device_list.size(); i++) {
+        rm::Camera* camera = new rm::Camera();
+        rm::openUVC(camera, 1920, 1080, 30, 24, device_list[i]);
+        rm::runUVC(camera, nullptr, 30);
+        cameras.push_back(camera);
+    }
+    
+    // 相机组按时间戳对齐各相机的帧
+    rm::CameraGroup group(5.0);
+    for (auto camera : cameras) {
+        group.addCamera(camera);
+    }
+    group.start();
+
+    TimePoint tp = getTime();
+    for (int n = 0; n < 3000; n++) {
+        std::shared_ptr<rm::FrameBundle> bundle = group.bundles.wait_pop(std::chrono::milliseconds(100));
+        if (bundle == nullptr) {
+            continue;
+        }
+
+        TimePoint tp1 = getTime();
+        double dt = getDoubleOfS(tp, tp1);
+        tp = tp1;
+
+        rm::print3d(bundle->frames.size(), dt, bundle->skew_ms, "cams", "dt", "skew");
+    }
+
+    for (size_t i = 0; i < group.size(); i++) {
+        rm::CameraGroupStat stat = group.getStat(i);
+        std::cout << "camera " << i << " drop rate " << stat.drop_rate << std::endl;
+    }
+    std::cout << "skew p99 " << group.getSkew().getPercentile(0.99) << " us" << std::endl;
+
+    // 先停止相机组，再关闭相机
+    group.stop();
+    for (auto camera : cameras) {
+        rm::closeUVC(camera);
+        delete camera;
+    }
+    return 0;
+}
@@ -0,0 +1,103 @@
+#include "pointer/pointer.h"
+#include "utils/timer.h"
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+static void drawRotatedRect(cv::Mat& binary, const cv::RotatedRect& rect, int thickness) {
+    cv::Point2f corners[4];
+    rect.points(corners);
+    std::vector<cv::Point> polygon;
+    for (int i = 0; i < 4; i++) polygon.push_back(cv::Point(cvRound(corners[i].x), cvRound(corners[i].y)));
+    if (thickness < 0) cv::fillConvexPoly(binary, polygon, cv::Scalar(255), cv::LINE_8);
+    else cv::polylines(binary, polygon, true, cv::Scalar(255), thickness, cv::LINE_8);
+}
+
+// 合成二值图：实心与空心灯条、空心框内嵌套的灯条、越过图像边界的灯条以及零散噪点
+static cv::Mat makeBinary(cv::RNG& rng) {
+    cv::Mat binary(480, 640, CV_8UC1, cv::Scalar(0));
+    for (int i = 0; i < 24; i++) {
+        cv::Point2f center(rng.uniform(-20.f, 660.f), rng.uniform(-20.f, 500.f));
+        float length = rng.uniform(6.f, 60.f);
+        float width = length * rng.uniform(0.1f, 0.6f);
+        cv::RotatedRect rect(center, cv::Size2f(width, length), rng.uniform(-60.f, 60.f));
+
+        int kind = rng.uniform(0, 4);
+        if (kind == 0) {
+            drawRotatedRect(binary, rect, -1);
+        } else if (kind == 1) {
+            drawRotatedRect(binary, rect, rng.uniform(1, 3));
+        } else if (kind == 2) {
+            // 空心框及其内部的实心灯条，内部灯条不是最外层轮廓
+            cv::RotatedRect outer(center, cv::Size2f(width * 3 + 12, length + 16), rect.angle);
+            drawRotatedRect(binary, outer, 1);
+            drawRotatedRect(binary, rect, -1);
+        } else {
+            cv::ellipse(binary, rect, cv::Scalar(255), rng.uniform(1, 3));
+        }
+    }
+    for (int i = 0; i < 200; i++) {
+        binary.at<uchar>(rng.uniform(0, binary.rows), rng.uniform(0, binary.cols)) = 255;
+    }
+    return binary;
+}
+
+// 不同连通域轮廓的起点互不相同，按起点排序后逐个比较
+static void sortLightbars(std::vector<rm::Lightbar>& lightbars) {
+    std::sort(lightbars.begin(), lightbars.end(), [](const rm::Lightbar& a, const rm::Lightbar& b) {
+        const cv::Point& pa = a.contour.front();
+        const cv::Point& pb = b.contour.front();
+        return (pa.y != pb.y) ? (pa.y < pb.y) : (pa.x < pb.x);
+    });
+}
+
+static bool sameLightbars(std::vector<rm::Lightbar>& a, std::vector<rm::Lightbar>& b) {
+    if (a.size() != b.size()) return false;
+    sortLightbars(a);
+    sortLightbars(b);
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].contour != b[i].contour) return false;
+    }
+    return true;
+}
+
+// 比较连通域提取与 findContours(RETR_EXTERNAL) + getLightbarsFromContours 的结果
+//
+// 用法：component_check
+int main() {
+    cv::RNG rng(2024);
+    rm::ArmorRefineParam param;
+    const int scenes = 200;
+
+    int mismatch = 0;
+    size_t contour_total = 0, component_total = 0;
+    double contour_us = 0, component_us = 0;
+    for (int s = 0; s < scenes; s++) {
+        cv::Mat binary = makeBinary(rng);
+
+        std::vector<std::vector<cv::Point>> contours;
+        std::vector<rm::Lightbar> by_contour, by_component;
+        TimePoint t0 = getTime();
+        cv::findContours(binary, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_NONE);
+        rm::getLightbarsFromContours(contours, by_contour, param.min_rect_side, param.max_rect_side,
+                                     param.min_value_area, param.min_ratio_area, param.max_angle);
+        TimePoint t1 = getTime();
+        rm::getLightbarsFromBinary(binary, by_component, param.min_rect_side, param.max_rect_side,
+                                   param.min_value_area, param.min_ratio_area, param.max_angle);
+        TimePoint t2 = getTime();
+
+        contour_us += getDoubleOfS(t0, t1) * 1e6;
+        component_us += getDoubleOfS(t1, t2) * 1e6;
+        contour_total += by_contour.size();
+        component_total += by_component.size();
+        if (!sameLightbars(by_contour, by_component)) mismatch++;
+    }
+
+    printf("%-10s %12s %12s\n", "method", "lightbars", "us/scene");
+    printf("%-10s %12zu %12.1f\n", "contour", contour_total, contour_us / scenes);
+    printf("%-10s %12zu %12.1f\n", "component", component_total, component_us / scenes);
+    printf("mismatch scenes %d/%d\n", mismatch, scenes);
+    printf("%s\n", mismatch == 0 ? "pass" : "fail");
+    return mismatch == 0 ? 0 : 1;
+}
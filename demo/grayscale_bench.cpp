@@ -0,0 +1,101 @@
+#include "pointer/pointer.h"
+#include "utils/timer.h"
+#include <opencv2/opencv.hpp>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// 原多次遍历实现，仅用于对比耗时与结果
+static void legacyGrayScale(const cv::Mat& input, cv::Mat& gray, rm::ArmorColor color, rm::GrayScaleMethod method) {
+    cv::Mat channels[3];
+    switch (method) {
+        case rm::GRAY_SCALE_METHOD_RGB:
+            cv::split(input, channels);
+            if (color == rm::ARMOR_COLOR_BLUE) gray = channels[0];
+            else if (color == rm::ARMOR_COLOR_RED) gray = channels[2];
+            else if (color == rm::ARMOR_COLOR_PURPLE) gray = channels[0] + channels[2];
+            else gray = channels[1];
+            break;
+
+        case rm::GRAY_SCALE_METHOD_HSV: {
+            cv::Mat hsv, mask;
+            cv::cvtColor(input, hsv, cv::COLOR_BGR2HSV);
+            if (color == rm::ARMOR_COLOR_BLUE) cv::inRange(hsv, cv::Scalar(100, 0, 0), cv::Scalar(124, 255, 255), mask);
+            else if (color == rm::ARMOR_COLOR_RED) cv::inRange(hsv, cv::Scalar(0, 0, 0), cv::Scalar(10, 255, 255), mask);
+            else if (color == rm::ARMOR_COLOR_PURPLE) cv::inRange(hsv, cv::Scalar(125, 0, 0), cv::Scalar(155, 255, 255), mask);
+            else cv::inRange(hsv, cv::Scalar(0, 0, 0), cv::Scalar(255, 255, 255), mask);
+            cv::bitwise_and(hsv, hsv, gray, mask);
+            cv::cvtColor(gray, gray, cv::COLOR_HSV2BGR);
+            cv::cvtColor(gray, gray, cv::COLOR_BGR2GRAY);
+            break;
+        }
+
+        case rm::GRAY_SCALE_METHOD_MIX:
+            if (color == rm::ARMOR_COLOR_BLUE || color == rm::ARMOR_COLOR_RED) {
+                legacyGrayScale(input, gray, color, rm::GRAY_SCALE_METHOD_RGB);
+            } else if (color == rm::ARMOR_COLOR_PURPLE) {
+                legacyGrayScale(input, gray, color, rm::GRAY_SCALE_METHOD_HSV);
+            } else {
+                cv::cvtColor(input, gray, cv::COLOR_BGR2GRAY);
+            }
+            break;
+
+        case rm::GRAY_SCALE_METHOD_SUB:
+            cv::split(input, channels);
+            if (color == rm::ARMOR_COLOR_BLUE) gray = channels[0] - channels[2];
+            else if (color == rm::ARMOR_COLOR_RED) gray = channels[2] - channels[0];
+            else if (color == rm::ARMOR_COLOR_PURPLE) gray = channels[0] + channels[2] - channels[1];
+            else gray = channels[1];
+            break;
+
+        default:
+            cv::cvtColor(input, gray, cv::COLOR_BGR2GRAY);
+            break;
+    }
+}
+
+template <class Func>
+static double timeit(Func func, int loop) {
+    func();
+    TimePoint t0 = getTime();
+    for (int i = 0; i < loop; i++) func();
+    return getDoubleOfS(t0, getTime()) * 1e3 / loop;
+}
+
+int main() {
+    const std::vector<cv::Size> sizes = {cv::Size(640, 480), cv::Size(1280, 1024), cv::Size(1920, 1080)};
+    const std::vector<std::pair<rm::GrayScaleMethod, std::string>> methods = {
+        {rm::GRAY_SCALE_METHOD_HSV, "HSV"},
+        {rm::GRAY_SCALE_METHOD_RGB, "RGB"},
+        {rm::GRAY_SCALE_METHOD_CVT, "CVT"},
+        {rm::GRAY_SCALE_METHOD_MIX, "MIX"},
+        {rm::GRAY_SCALE_METHOD_SUB, "SUB"}
+    };
+    const std::vector<rm::ArmorColor> colors = {rm::ARMOR_COLOR_BLUE, rm::ARMOR_COLOR_RED, rm::ARMOR_COLOR_PURPLE};
+    const int loop = 50;
+
+    printf("%-11s %-4s %-6s %10s %10s %8s\n", "size", "mode", "color", "legacy ms", "fused ms", "maxdiff");
+    for (const auto& size : sizes) {
+        cv::Mat input(size, CV_8UC3);
+        cv::randu(input, cv::Scalar::all(0), cv::Scalar::all(256));
+
+        for (const auto& method : methods) {
+            for (auto color : colors) {
+                cv::Mat legacy, fused;
+                double legacy_ms = timeit([&] { legacyGrayScale(input, legacy, color, method.first); }, loop);
+                double fused_ms = timeit([&] { rm::getGrayScale(input, fused, color, method.first); }, loop);
+
+                cv::Mat diff;
+                cv::absdiff(legacy, fused, diff);
+                double max_diff;
+                cv::minMaxLoc(diff, nullptr, &max_diff);
+
+                std::string size_str = std::to_string(size.width) + "x" + std::to_string(size.height);
+                printf("%-11s %-4s %-6s %10.3f %10.3f %8.0f\n",
+                       size_str.c_str(), method.second.c_str(), rm::getStringArmorColor(color).c_str(),
+                       legacy_ms, fused_ms, max_diff);
+            }
+        }
+    }
+    return 0;
+}
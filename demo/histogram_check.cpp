@@ -0,0 +1,180 @@
+#include "pointer/pointer.h"
+#include "pointer/histogram.h"
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+// 合成图像：暗背景加若干亮块，像素值不超过 249
+// 直方图末端总有空箱，最小值为 0，归一化不引入偏移，与 cv::normalize 逐位一致
+static cv::Mat makeImage(cv::RNG& rng, int type) {
+    cv::Mat image(480, 640, type);
+    rng.fill(image, cv::RNG::NORMAL, cv::Scalar::all(30), cv::Scalar::all(12));
+    for (int i = 0; i < 20; i++) {
+        cv::Rect rect(rng.uniform(-40, 640), rng.uniform(-40, 480), rng.uniform(4, 80), rng.uniform(4, 80));
+        cv::Scalar color(rng.uniform(120, 250), rng.uniform(120, 250), rng.uniform(120, 250));
+        cv::rectangle(image, rect, color, cv::FILLED);
+    }
+    cv::min(image, cv::Scalar::all(249), image);
+    return image;
+}
+
+// 与上一个 ROI 重叠、不相交或越过图像边界的新 ROI，保证与图像有交集
+static cv::Rect nextROI(cv::RNG& rng, const cv::Rect& last, const cv::Size& size, int kind) {
+    cv::Rect roi;
+    do {
+        if (kind == 0) {
+            roi = last + cv::Point(rng.uniform(-last.width / 2, last.width / 2 + 1),
+                                   rng.uniform(-last.height / 2, last.height / 2 + 1));
+            roi += cv::Size(rng.uniform(-8, 9), rng.uniform(-8, 9));
+        } else if (kind == 1) {
+            roi = cv::Rect(rng.uniform(0, size.width), rng.uniform(0, size.height),
+                           rng.uniform(8, 160), rng.uniform(8, 160));
+        } else {
+            roi = cv::Rect(rng.uniform(-100, size.width), rng.uniform(-100, size.height),
+                           rng.uniform(110, 260), rng.uniform(110, 260));
+        }
+        roi.width = std::max(roi.width, 1);
+        roi.height = std::max(roi.height, 1);
+    } while ((roi & cv::Rect(cv::Point(0, 0), size)).area() <= 0);
+    return roi;
+}
+
+// 原实现：calcHist 统计后按 0 ~ 512 归一化
+static void legacyHistogram(const cv::Mat& src, const cv::Rect& roi, int channel, cv::Mat& plane, cv::Mat& histogram) {
+    cv::Mat region = src(roi & cv::Rect(0, 0, src.cols, src.rows));
+    if (src.channels() == 1) plane = region;
+    else if (channel < 0) cv::cvtColor(region, plane, cv::COLOR_BGR2GRAY);
+    else cv::extractChannel(region, plane, channel);
+
+    int hist_size = 256;
+    float range[] = {0, 256};
+    const float* hist_range = {range};
+    cv::calcHist(&plane, 1, 0, cv::Mat(), histogram, 1, &hist_size, &hist_range, true, false);
+    cv::normalize(histogram, histogram, 0, 512, cv::NORM_MINMAX, -1, cv::Mat());
+}
+
+// 原 getHistDoublePeak
+static std::pair<int, int> legacyDoublePeak(const cv::Mat& histogram) {
+    int firstPeak = 0;
+    double maxVal;
+    int histSize = histogram.total();
+    cv::minMaxLoc(histogram, NULL, &maxVal, NULL, NULL);
+    for (int i = 0; i < histSize; ++i) {
+        if (histogram.at<float>(i) == maxVal) {
+            firstPeak = i;
+            break;
+        }
+    }
+
+    int myend = 0;
+    for (int i = firstPeak; i < histSize; ++i) {
+        if (histogram.at<float>(i) <= 3) {
+            myend = (i + 30 > 250) ? 250 : (i + 30);
+            break;
+        }
+    }
+
+    cv::Mat RestDists = cv::Mat::zeros(256, 1, CV_32F);
+    for (int k = 0; k < myend && k < histSize; k++) {
+        RestDists.at<float>(k) = std::pow(k - firstPeak, 2) * histogram.at<float>(k);
+    }
+
+    cv::Point my_p;
+    cv::minMaxLoc(RestDists, NULL, &maxVal, NULL, &my_p);
+    int secondPeak = my_p.y;
+    if (secondPeak > 255) {
+        secondPeak = 255;
+    }
+    return std::pair<int, int>(firstPeak, secondPeak);
+}
+
+// 原 getThresholdFromHist
+static int legacyCutThreshold(const cv::Mat& histogram, int Cut_thresold, int bios) {
+    int my_End = 80, my_Begin = 10;
+    int final_thread = my_Begin;
+    for (int i = my_End; i > my_Begin; i--) {
+        if (histogram.at<float>(i) >= Cut_thresold) {
+            final_thread = i;
+            break;
+        }
+    }
+    final_thread = final_thread + bios;
+    if (final_thread >= 255) {
+        final_thread = 254;
+    }
+    return final_thread;
+}
+
+struct Result {
+    int steps = 0;
+    int bins = 0;           // slide 与重新 build 的直方图不一致
+    int otsu = 0;           // 与 cv::THRESH_OTSU 不一致
+    int legacy = 0;         // 归一化结果、双峰或截断阈值与原实现不一致
+};
+
+static void check(cv::RNG& rng, const cv::Mat& src, int channel, uint64_t frame_id, Result& result) {
+    const cv::Size size = src.size();
+    cv::Rect roi = nextROI(rng, cv::Rect(0, 0, 64, 64), size, 1);
+    rm::Histogram sliding;
+    sliding.build(src, roi, channel, frame_id);
+
+    for (int step = 0; step < 300; step++) {
+        roi = nextROI(rng, roi, size, rng.uniform(0, 3));
+        sliding.slide(src, roi, frame_id);
+
+        rm::Histogram fresh;
+        fresh.build(src, roi, channel, frame_id);
+        bool same = sliding.getTotal() == fresh.getTotal() && sliding.getROI() == fresh.getROI();
+        for (int i = 0; i < 256 && same; i++) same = sliding.getBins()[i] == fresh.getBins()[i];
+        result.bins += !same;
+
+        cv::Mat plane, histogram, binary, normalized;
+        legacyHistogram(src, roi, channel, plane, histogram);
+        int otsu = static_cast<int>(cv::threshold(plane, binary, 0, 255, cv::THRESH_BINARY | cv::THRESH_OTSU));
+        result.otsu += sliding.getOtsuThreshold() != otsu;
+
+        sliding.getNormalized(normalized);
+        bool legacy = cv::norm(normalized, histogram, cv::NORM_INF) == 0 &&
+                      sliding.getDoublePeak() == legacyDoublePeak(histogram);
+        for (int cut : {5, 20, 60, 200}) {
+            legacy = legacy && sliding.getCutThreshold(cut, 3) == legacyCutThreshold(histogram, cut, 3);
+        }
+        result.legacy += !legacy;
+        result.steps++;
+    }
+}
+
+// Histogram::slide 与重新 build、cv::THRESH_OTSU 以及原 calcHist 流程的一致性检查
+//
+// 用法：histogram_check
+int main() {
+    cv::RNG rng(2024);
+    struct Case {
+        const char* name;
+        int type;
+        int channel;
+    } cases[] = {
+        {"gray", CV_8UC1, -1},
+        {"bgr", CV_8UC3, -1},
+        {"blue", CV_8UC3, 0},
+        {"green", CV_8UC3, 1},
+        {"red", CV_8UC3, 2},
+    };
+
+    bool pass = true;
+    printf("%-8s %8s %8s %8s %8s\n", "input", "steps", "bins", "otsu", "legacy");
+    for (const Case& c : cases) {
+        Result result;
+        for (int image = 0; image < 4; image++) {
+            cv::Mat src = makeImage(rng, c.type);
+            check(rng, src, c.channel, image + 1, result);
+        }
+        printf("%-8s %8d %8d %8d %8d\n", c.name, result.steps, result.bins, result.otsu, result.legacy);
+        pass &= (result.bins == 0) && (result.otsu == 0) && (result.legacy == 0);
+    }
+    printf("%s\n", pass ? "pass" : "fail");
+    return pass ? 0 : 1;
+}
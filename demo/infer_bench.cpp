@@ -0,0 +1,71 @@
+#include "infer/infer.h"
+#include "utils/timer.h"
+#include <opencv2/opencv.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// CPU 端到端耗时：letterbox + 前向 + 后处理，不需要 GPU
+//
+// 用法：infer_bench <onnx> [v5|fp|fpx] [image] [fp32|fp16|int8] [threads]
+// 不给图像时使用合成图像，只用于计时
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        printf("usage: %s <onnx> [v5|fp|fpx] [image] [fp32|fp16|int8] [threads]\n", argv[0]);
+        return 1;
+    }
+    std::string onnx_file = argv[1];
+    std::string model = (argc > 2) ? argv[2] : "fp";
+    std::string image_file = (argc > 3) ? argv[3] : "";
+    std::string precision = (argc > 4) ? argv[4] : "fp32";
+
+    rm::InferParam param;
+    param.precision = (precision == "fp16") ? rm::INFER_PRECISION_FP16 :
+                      (precision == "int8") ? rm::INFER_PRECISION_INT8 : rm::INFER_PRECISION_FP32;
+    param.thread_num = (argc > 5) ? atoi(argv[5]) : 0;
+
+    cv::Mat image;
+    if (!image_file.empty()) image = cv::imread(image_file, cv::IMREAD_COLOR);
+    if (image.empty()) {
+        image = cv::Mat(1024, 1280, CV_8UC3);
+        cv::randu(image, cv::Scalar::all(0), cv::Scalar::all(255));
+    }
+
+    rm::DnnInfer backend;
+    if (!backend.init(onnx_file, param)) return 1;
+
+    int head = (model == "v5") ? 5 : (model == "fpx") ? 13 : 9;
+    int classes_num = backend.getStructSize() - head;
+    rm::NmsContext context;
+    context.setThreshold(0.5f, 0.45f);
+    context.setClassesNum(classes_num);
+
+    const int warmup = 5;
+    const int loop = 50;
+    for (int i = 0; i < warmup; i++) backend.infer(image);
+
+    double infer_ms = 0, nms_ms = 0;
+    size_t detected = 0;
+    for (int i = 0; i < loop; i++) {
+        TimePoint t0 = getTime();
+        backend.infer(image);
+        TimePoint t1 = getTime();
+        backend.setNmsGeometry(context);
+        const std::vector<rm::YoloRect>& result =
+            (model == "v5") ? context.runV5(backend.getOutput(), backend.getBboxesNum()) :
+            (model == "fpx") ? context.runFPX(backend.getOutput(), backend.getBboxesNum()) :
+            context.runFP(backend.getOutput(), backend.getBboxesNum());
+        TimePoint t2 = getTime();
+        infer_ms += getDoubleOfS(t0, t1) * 1e3;
+        nms_ms += getDoubleOfS(t1, t2) * 1e3;
+        detected = result.size();
+    }
+
+    printf("backend opencv-dnn, precision %s, threads %d, output %d x %d, classes %d\n",
+           precision.c_str(), backend.getThreadNum(), backend.getBboxesNum(), backend.getStructSize(), classes_num);
+    printf("infer %.2f ms, nms %.3f ms, total %.2f ms, %.1f fps, detected %zu\n",
+           infer_ms / loop, nms_ms / loop, (infer_ms + nms_ms) / loop,
+           1000.0 * loop / (infer_ms + nms_ms), detected);
+    return 0;
+}
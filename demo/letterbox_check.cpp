@@ -0,0 +1,159 @@
+#include "infer/infer.h"
+#include "utils/timer.h"
+#include <opencv2/opencv.hpp>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <vector>
+
+static const int INFER_SIZE = 640;
+
+// warpaffine_kernel 的逐像素移植，按 nvcc 默认 --fmad=true 的方式收缩乘加，作为对照
+static void referenceLetterbox(const cv::Mat& src, float* dst, int dst_width, int dst_height, uint8_t const_value_st) {
+    float input_to_infer[6], m[6];
+    rm::getLetterboxMatrix(src.cols, src.rows, dst_width, dst_height, input_to_infer, m);
+    const int src_width = src.cols, src_height = src.rows;
+    const int area = dst_width * dst_height;
+
+    for (int dy = 0; dy < dst_height; dy++) {
+        for (int dx = 0; dx < dst_width; dx++) {
+            float src_x = fmaf(m[0], (float)dx, m[1] * dy) + m[2] + 0.5f;
+            float src_y = fmaf(m[3], (float)dx, m[4] * dy) + m[5] + 0.5f;
+            float c0, c1, c2;
+
+            if (src_x <= -1 || src_x >= src_width || src_y <= -1 || src_y >= src_height) {
+                c0 = const_value_st;
+                c1 = const_value_st;
+                c2 = const_value_st;
+            } else {
+                int y_low = floorf(src_y);
+                int x_low = floorf(src_x);
+                int y_high = y_low + 1;
+                int x_high = x_low + 1;
+
+                uint8_t const_value[] = {const_value_st, const_value_st, const_value_st};
+                float ly = src_y - y_low;
+                float lx = src_x - x_low;
+                float hy = 1 - ly;
+                float hx = 1 - lx;
+                float w1 = hy * hx, w2 = hy * lx, w3 = ly * hx, w4 = ly * lx;
+                const uint8_t* v1 = const_value;
+                const uint8_t* v2 = const_value;
+                const uint8_t* v3 = const_value;
+                const uint8_t* v4 = const_value;
+                if (y_low >= 0) {
+                    if (x_low >= 0) v1 = src.ptr<uint8_t>(y_low) + x_low * 3;
+                    if (x_high < src_width) v2 = src.ptr<uint8_t>(y_low) + x_high * 3;
+                }
+                if (y_high < src_height) {
+                    if (x_low >= 0) v3 = src.ptr<uint8_t>(y_high) + x_low * 3;
+                    if (x_high < src_width) v4 = src.ptr<uint8_t>(y_high) + x_high * 3;
+                }
+                c0 = fmaf(w4, v4[0], fmaf(w3, v3[0], fmaf(w1, v1[0], w2 * v2[0])));
+                c1 = fmaf(w4, v4[1], fmaf(w3, v3[1], fmaf(w1, v1[1], w2 * v2[1])));
+                c2 = fmaf(w4, v4[2], fmaf(w3, v3[2], fmaf(w1, v1[2], w2 * v2[2])));
+            }
+
+            float t = c2;
+            c2 = c0;
+            c0 = t;
+            float* pdst_c0 = dst + dy * dst_width + dx;
+            pdst_c0[0] = c0 / 255.0f;
+            pdst_c0[area] = c1 / 255.0f;
+            pdst_c0[area * 2] = c2 / 255.0f;
+        }
+    }
+}
+
+// 逐位比较，返回不同的元素数
+static size_t compare(const std::vector<float>& a, const std::vector<float>& b, float& max_diff) {
+    size_t mismatch = 0;
+    max_diff = 0;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (memcmp(&a[i], &b[i], sizeof(float)) != 0) mismatch++;
+        max_diff = std::max(max_diff, std::fabs(a[i] - b[i]));
+    }
+    return mismatch;
+}
+
+// 与 letterbox 逐位比较，并与原先 warpAffine + blobFromImage 的组合对比耗时
+//
+// 用法：letterbox_check [image]
+int main(int argc, char** argv) {
+    cv::RNG rng(2024);
+    std::vector<cv::Size> sizes = {
+        cv::Size(1280, 1024), cv::Size(1920, 1080), cv::Size(640, 480), cv::Size(640, 640),
+        cv::Size(320, 256), cv::Size(101, 37), cv::Size(37, 101), cv::Size(2, 2)
+    };
+    std::vector<cv::Mat> images;
+    if (argc > 1) {
+        cv::Mat image = cv::imread(argv[1], cv::IMREAD_COLOR);
+        if (!image.empty()) images.push_back(image);
+    }
+    for (const cv::Size& size : sizes) {
+        cv::Mat image(size, CV_8UC3);
+        rng.fill(image, cv::RNG::UNIFORM, 0, 256);
+        images.push_back(image);
+    }
+
+    const int area = INFER_SIZE * INFER_SIZE;
+    std::vector<float> reference(area * 3), output(area * 3);
+    bool pass = true;
+
+    printf("%-6s %-11s %10s %10s %12s %12s %12s\n", "input", "size", "mismatch", "max diff",
+           "letterbox us", "opencv us", "opencv diff");
+    for (int yuyv = 0; yuyv < 2; yuyv++) {
+        for (const cv::Mat& image : images) {
+            cv::Mat bgr, src;
+            if (yuyv) {
+                if (image.cols % 2 != 0) continue;
+                src.create(image.size(), CV_8UC2);
+                rng.fill(src, cv::RNG::UNIFORM, 0, 256);
+                cv::cvtColor(src, bgr, cv::COLOR_YUV2BGR_YUYV);
+            } else {
+                bgr = src = image;
+            }
+
+            referenceLetterbox(bgr, reference.data(), INFER_SIZE, INFER_SIZE, 114);
+            if (yuyv) rm::letterboxYUYV(src, output.data(), INFER_SIZE, INFER_SIZE);
+            else rm::letterbox(src, output.data(), INFER_SIZE, INFER_SIZE);
+            float max_diff = 0;
+            size_t mismatch = compare(reference, output, max_diff);
+            if (mismatch != 0) pass = false;
+
+            const int loop = 50;
+            TimePoint t0 = getTime();
+            for (int i = 0; i < loop; i++) {
+                if (yuyv) rm::letterboxYUYV(src, output.data(), INFER_SIZE, INFER_SIZE);
+                else rm::letterbox(src, output.data(), INFER_SIZE, INFER_SIZE);
+            }
+            TimePoint t1 = getTime();
+
+            // 原先 DnnInfer 的预处理，YUYV 输入需要先整幅转换
+            float input_to_infer[6], infer_to_input[6];
+            rm::getLetterboxMatrix(image.cols, image.rows, INFER_SIZE, INFER_SIZE, input_to_infer, infer_to_input);
+            cv::Mat matrix(2, 3, CV_32F, input_to_infer), converted, resized, blob;
+            for (int i = 0; i < loop; i++) {
+                if (yuyv) cv::cvtColor(src, converted, cv::COLOR_YUV2BGR_YUYV);
+                else converted = src;
+                cv::warpAffine(converted, resized, matrix, cv::Size(INFER_SIZE, INFER_SIZE),
+                               cv::INTER_LINEAR, cv::BORDER_CONSTANT, cv::Scalar(114, 114, 114));
+                cv::dnn::blobFromImage(resized, blob, 1.0 / 255.0, cv::Size(), cv::Scalar(), true, false, CV_32F);
+            }
+            TimePoint t2 = getTime();
+            std::vector<float> opencv(blob.ptr<float>(), blob.ptr<float>() + area * 3);
+            float opencv_diff = 0;
+            compare(reference, opencv, opencv_diff);
+
+            char size_text[32];
+            snprintf(size_text, sizeof(size_text), "%dx%d", image.cols, image.rows);
+            printf("%-6s %-11s %10zu %10.2e %12.1f %12.1f %12.2e\n", yuyv ? "yuyv" : "bgr", size_text,
+                   mismatch, max_diff, getDoubleOfS(t0, t1) * 1e6 / loop, getDoubleOfS(t1, t2) * 1e6 / loop,
+                   opencv_diff);
+        }
+    }
+    printf("%s\n", pass ? "pass" : "fail");
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,117 @@
+#include "pointer/pointer.h"
+#include "utils/timer.h"
+#include <opencv2/opencv.hpp>
+#include <cstdio>
+#include <random>
+#include <algorithm>
+#include <vector>
+
+// 灯条匹配参数
+static const double MAX_RATIO_LENGTH = 2.0;
+static const double MAX_RATIO_AREA = 4.0;
+static const double MIN_RATIO_SIDE = 1.0;
+static const double MAX_RATIO_SIDE = 5.0;
+static const double MAX_ANGLE_DIFF = 10.0;
+static const double MAX_ANGLE_AVG = 45.0;
+static const double MAX_OFFSET = 1.0;
+
+// 原 O(n^2) 实现，仅用于对比耗时与结果
+static bool legacyMatch(const std::vector<rm::Lightbar>& lightbars, const rm::Armor& armor, rm::LightbarPair& best_pair) {
+    std::vector<rm::LightbarPair> lightbar_pair_list;
+    for (size_t i = 0; i < lightbars.size(); i++) {
+        for (size_t j = i + 1; j < lightbars.size(); j++) {
+            if (rm::isLightBarMatched(lightbars[i], lightbars[j], MAX_RATIO_LENGTH, MAX_RATIO_AREA, MIN_RATIO_SIDE,
+                                      MAX_RATIO_SIDE, MAX_ANGLE_DIFF, MAX_ANGLE_AVG, MAX_OFFSET)) {
+                lightbar_pair_list.push_back(rm::LightbarPair(lightbars[i], lightbars[j]));
+            }
+        }
+    }
+    if (lightbar_pair_list.empty()) {
+        best_pair = rm::LightbarPair();
+        return false;
+    }
+    best_pair = (lightbar_pair_list.size() == 1) ? lightbar_pair_list[0] :
+                rm::getBestMatchedLightbarPair(lightbar_pair_list, armor);
+    return true;
+}
+
+static rm::Lightbar makeLightbar(float x, float y, float length, float width, float angle) {
+    cv::RotatedRect rect(cv::Point2f(x, y), cv::Size2f(width, length), angle);
+    cv::Point2f corners[4];
+    rect.points(corners);
+    std::vector<cv::Point> contour;
+    for (int i = 0; i < 4; i++) contour.push_back(cv::Point(cvRound(corners[i].x), cvRound(corners[i].y)));
+
+    rm::Lightbar lightbar;
+    rm::setLightbar(lightbar, contour);
+    return lightbar;
+}
+
+// 场地背景：大量随机分布、长度相近的灯带，其中混有若干真实装甲板灯条对
+static std::vector<rm::Lightbar> makeScene(int num, std::mt19937& rng) {
+    std::uniform_real_distribution<float> pos_x(0, 1280), pos_y(0, 1024);
+    std::uniform_real_distribution<float> len(8, 40), tilt(-20, 20), jitter(-2, 2);
+
+    std::vector<rm::Lightbar> lightbars;
+    int armor_num = std::max(1, num / 10);
+    for (int i = 0; i < armor_num && (int)lightbars.size() + 2 <= num; i++) {
+        float x = pos_x(rng), y = pos_y(rng), l = len(rng), a = tilt(rng) * 0.3f;
+        lightbars.push_back(makeLightbar(x, y, l, l * 0.25f, a));
+        lightbars.push_back(makeLightbar(x + l * 2.3f, y + jitter(rng), l + jitter(rng), l * 0.25f, a + jitter(rng)));
+    }
+    while ((int)lightbars.size() < num) {
+        float l = len(rng);
+        lightbars.push_back(makeLightbar(pos_x(rng), pos_y(rng), l, l * 0.2f, tilt(rng)));
+    }
+    std::shuffle(lightbars.begin(), lightbars.end(), rng);
+    return lightbars;
+}
+
+static bool samePair(const rm::LightbarPair& a, const rm::LightbarPair& b) {
+    return a.first.rect.center == b.first.rect.center && a.second.rect.center == b.second.rect.center;
+}
+
+int main() {
+    std::mt19937 rng(2024);
+    const std::vector<int> counts = {10, 20, 50, 100, 200};
+    const int scenes = 50;
+    const int loop = 20;
+
+    int total_mismatch = 0;
+    printf("%-6s %12s %12s %8s %10s\n", "bars", "legacy us", "sorted us", "speedup", "mismatch");
+    for (int count : counts) {
+        double legacy_us = 0, sorted_us = 0;
+        int mismatch = 0;
+        for (int s = 0; s < scenes; s++) {
+            std::vector<rm::Lightbar> lightbars = makeScene(count, rng);
+            rm::Armor armor;
+            armor.center = cv::Point2f(640, 512);
+
+            rm::LightbarPair legacy_pair, sorted_pair;
+            bool legacy_ok = false, sorted_ok = false;
+
+            TimePoint t0 = getTime();
+            for (int i = 0; i < loop; i++) legacy_ok = legacyMatch(lightbars, armor, legacy_pair);
+            TimePoint t1 = getTime();
+            for (int i = 0; i < loop; i++) {
+                sorted_ok = rm::getBestMatchedLightbarPair(lightbars, armor, sorted_pair,
+                    MAX_RATIO_LENGTH, MAX_RATIO_AREA, MIN_RATIO_SIDE, MAX_RATIO_SIDE,
+                    MAX_ANGLE_DIFF, MAX_ANGLE_AVG, MAX_OFFSET);
+            }
+            TimePoint t2 = getTime();
+
+            legacy_us += getDoubleOfS(t0, t1) * 1e6 / loop;
+            sorted_us += getDoubleOfS(t1, t2) * 1e6 / loop;
+            if (legacy_ok != sorted_ok || (legacy_ok && !samePair(legacy_pair, sorted_pair))) mismatch++;
+        }
+        legacy_us /= scenes;
+        sorted_us /= scenes;
+        printf("%-6d %12.2f %12.2f %8.2f %10d\n", count, legacy_us, sorted_us, legacy_us / sorted_us, mismatch);
+        total_mismatch += mismatch;
+    }
+
+    // 排序剪枝后的匹配结果须与逐对遍历完全相同
+    bool pass = (total_mismatch == 0);
+    printf("%s\n", pass ? "pass" : "fail");
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,350 @@
+#include "infer/nms.h"
+#include "utils/timer.h"
+#include <opencv2/opencv.hpp>
+#include <cstdio>
+#include <random>
+#include <algorithm>
+#include <vector>
+#include <cmath>
+
+// 640 输入的 yolov5 输出行数
+static const int BBOXES_NUM = 25200;
+static const int CLASSES_NUM = 36;
+static const int INFER_SIZE = 640;
+static const int INPUT_WIDTH = 1280;
+static const int INPUT_HEIGHT = 1024;
+static const float CONFIDENCE_THRESHOLD = 0.5f;
+static const float NMS_THRESHOLD = 0.45f;
+
+// 模型输出排布：head 为类别置信度之前的 float 数，color 为颜色置信度的起始位置（无则为 -1）
+struct ModelLayout {
+    const char* name;
+    int head;
+    int color;
+    bool four_points;
+    bool scale_by_objectness;                           // V5C36 的类别置信度不乘目标置信度
+};
+
+static const ModelLayout MODELS[4] = {
+    {"v5", 5, -1, false, true},
+    {"fp", 9, -1, true, true},
+    {"fpx", 13, 9, true, true},
+    {"v5c36", 5, -1, false, false},
+};
+
+// 合成推理输出：目标置信度普遍很低，只有 density 比例的行超过阈值，且成簇出现以产生重叠框
+// 约 1% 的行在随机位置写入 NaN，覆盖 FP16 输出中偶发的 NaN
+static void makeOutput(std::vector<float>& output, const ModelLayout& layout, int yolo_size, double density, std::mt19937& rng) {
+    std::uniform_real_distribution<float> unit(0.f, 1.f);
+    std::uniform_real_distribution<float> low(0.f, 0.1f);
+    std::uniform_real_distribution<float> pos(40.f, INFER_SIZE - 40.f);
+    output.assign((size_t)BBOXES_NUM * yolo_size, 0.f);
+
+    float cx = pos(rng), cy = pos(rng);
+    for (int i = 0; i < BBOXES_NUM; i++) {
+        float* row = output.data() + (size_t)i * yolo_size;
+        bool hit = unit(rng) < density;
+        if (hit && unit(rng) < 0.3f) {
+            cx = pos(rng);
+            cy = pos(rng);
+        }
+        float x = hit ? cx + unit(rng) * 4.f : pos(rng);
+        float y = hit ? cy + unit(rng) * 4.f : pos(rng);
+        float w = 30.f + unit(rng) * 10.f, h = 15.f + unit(rng) * 5.f;
+        if (layout.four_points) {
+            float pose[8] = {x - w / 2, y - h / 2, x - w / 2, y + h / 2, x + w / 2, y + h / 2, x + w / 2, y - h / 2};
+            for (int k = 0; k < 8; k++) row[k] = pose[k];
+        } else {
+            row[0] = x; row[1] = y; row[2] = w; row[3] = h;
+        }
+        int objectness = layout.four_points ? 8 : 4;
+        row[objectness] = hit ? 0.6f + unit(rng) * 0.4f : low(rng);
+        for (int c = objectness + 1; c < yolo_size; c++) row[c] = low(rng);
+        if (hit) {
+            row[layout.head + (int)(unit(rng) * (yolo_size - layout.head))] = 0.9f + unit(rng) * 0.1f;
+            if (layout.color >= 0) row[layout.color + (int)(unit(rng) * 3)] = 0.9f + unit(rng) * 0.1f;
+        }
+        if (unit(rng) < 0.01f) row[objectness + 1 + (int)(unit(rng) * (yolo_size - objectness - 1))] = NAN;
+        // 偶发的超大类别分数，乘以低目标置信度后仍超过阈值，只能由目标置信度筛选排除
+        if (!hit && unit(rng) < 0.005f) row[layout.head + (int)(unit(rng) * (yolo_size - layout.head))] = 20.f;
+    }
+}
+
+// 原实现的坐标换算，与 NmsContext 独立实现，用于核对解码结果
+struct LegacyGeometry {
+    float ratio, top, left;
+
+    LegacyGeometry() {
+        float width_ratio = (float)INPUT_WIDTH / (float)INFER_SIZE;
+        float height_ratio = (float)INPUT_HEIGHT / (float)INFER_SIZE;
+        top = ((float)INFER_SIZE * width_ratio - (float)INPUT_HEIGHT) / 2.f;
+        left = ((float)INFER_SIZE * height_ratio - (float)INPUT_WIDTH) / 2.f;
+        if (width_ratio > height_ratio) {
+            ratio = width_ratio;
+            left = 0;
+        } else {
+            ratio = height_ratio;
+            top = 0;
+        }
+    }
+
+    cv::Rect boxRect(const float* bbox) const {
+        float half_w = bbox[2] / 2.f, half_h = bbox[3] / 2.f;
+        float l = (bbox[0] - half_w) * ratio - left;
+        float t = (bbox[1] - half_h) * ratio - top;
+        float r = (bbox[0] + half_w) * ratio - left;
+        float b = (bbox[1] + half_h) * ratio - top;
+        return cv::Rect(round(l), round(t), round(r - l), round(b - t));
+    }
+
+    cv::Rect poseRect(const float* pose) const {
+        float min_x = std::min(std::min(pose[0], pose[2]), std::min(pose[4], pose[6]));
+        float max_x = std::max(std::max(pose[0], pose[2]), std::max(pose[4], pose[6]));
+        float min_y = std::min(std::min(pose[1], pose[3]), std::min(pose[5], pose[7]));
+        float max_y = std::max(std::max(pose[1], pose[3]), std::max(pose[5], pose[7]));
+        return cv::Rect(round(min_x * ratio - left), round(min_y * ratio - top),
+                        round((max_x - min_x) * ratio), round((max_y - min_y) * ratio));
+    }
+
+    std::vector<cv::Point2f> posePoints(const float* pose) const {
+        const int x_index[4] = {0, 6, 2, 4};
+        const int y_index[4] = {1, 7, 3, 5};
+        std::vector<cv::Point2f> four_points;
+        for (int i = 0; i < 4; i++) {
+            double x = pose[x_index[i]] * ratio - left;
+            double y = pose[y_index[i]] * ratio - top;
+            if (x < 0 || x >= INPUT_WIDTH || y < 0 || y >= INPUT_HEIGHT) return std::vector<cv::Point2f>();
+            four_points.push_back(cv::Point2f(x, y));
+        }
+        return four_points;
+    }
+
+    static bool poseInside(const float* pose) {
+        for (int i = 0; i < 4; i++) {
+            if (pose[2 * i] < 1e-3 || pose[2 * i] > (INFER_SIZE - 1.001) ||
+                pose[2 * i + 1] < 1e-3 || pose[2 * i + 1] > (INFER_SIZE - 1.001)) return false;
+        }
+        return true;
+    }
+};
+
+// 原实现的逐个严格大于比较
+static int legacyScore(const float* score, int num, float scale, float& best) {
+    int index = -1;
+    best = 0;
+    for (int c = 0; c < num; c++) {
+        float confidence = score[c] * scale;
+        if (confidence > best && confidence > CONFIDENCE_THRESHOLD) {
+            index = c;
+            best = confidence;
+        }
+    }
+    return index;
+}
+
+// 原实现的逐行解码，得到 nms 之前的推理框
+static std::vector<rm::YoloRect> legacyDecode(const std::vector<float>& output, const ModelLayout& layout,
+                                              int yolo_size, const LegacyGeometry& geometry) {
+    std::vector<rm::YoloRect> list;
+    int classes_num = yolo_size - layout.head;
+    for (int i = 0; i < BBOXES_NUM; i++) {
+        const float* row = output.data() + (size_t)i * yolo_size;
+        float iou_confidence = row[layout.four_points ? 8 : 4];
+        if (iou_confidence < CONFIDENCE_THRESHOLD) continue;
+
+        rm::YoloRect rect;
+        if (layout.color >= 0) {
+            float color_confidence;
+            rect.color_id = legacyScore(row + layout.color, 3, iou_confidence, color_confidence);
+            if (rect.color_id == -1) continue;
+        }
+        float class_confidence;
+        rect.class_id = legacyScore(row + layout.head, classes_num,
+                                    layout.scale_by_objectness ? iou_confidence : 1.f, class_confidence);
+        if (rect.class_id == -1) continue;
+        rect.confidence = layout.scale_by_objectness ? class_confidence : iou_confidence;
+
+        if (layout.four_points) {
+            if (!LegacyGeometry::poseInside(row)) continue;
+            rect.box = geometry.poseRect(row);
+            rect.four_points = geometry.posePoints(row);
+            if (rect.four_points.size() != 4) continue;
+        } else {
+            rect.box = geometry.boxRect(row);
+        }
+        list.push_back(rect);
+    }
+    return list;
+}
+
+// 阈值大于 1 时 nms 不抑制任何框，run 的结果即为按置信度稳定排序的解码结果
+// V5C36 按类别分组，每类单独排序，超过 4 个框的类别整类跳过
+static std::vector<rm::YoloRect> legacyUnsuppressed(std::vector<rm::YoloRect> list, const ModelLayout& layout, int classes_num) {
+    auto by_confidence = [](const rm::YoloRect& a, const rm::YoloRect& b) { return a.confidence > b.confidence; };
+    if (layout.scale_by_objectness) {
+        std::stable_sort(list.begin(), list.end(), by_confidence);
+        return list;
+    }
+    std::vector<rm::YoloRect> result;
+    for (int c = 0; c < classes_num; c++) {
+        std::vector<rm::YoloRect> class_list;
+        for (const rm::YoloRect& rect : list) {
+            if (rect.class_id == c) class_list.push_back(rect);
+        }
+        if (class_list.size() > 4) continue;
+        std::stable_sort(class_list.begin(), class_list.end(), by_confidence);
+        result.insert(result.end(), class_list.begin(), class_list.end());
+    }
+    return result;
+}
+
+static const std::vector<rm::YoloRect>& runModel(rm::NmsContext& context, const ModelLayout& layout, const float* output) {
+    if (layout.color >= 0) return context.runFPX(output, BBOXES_NUM);
+    if (!layout.scale_by_objectness) return context.runV5C36(output, BBOXES_NUM);
+    if (layout.four_points) return context.runFP(output, BBOXES_NUM);
+    return context.runV5(output, BBOXES_NUM);
+}
+
+// 逐项比较推理框，置信度与四点按位比较
+static bool sameDecoded(const std::vector<rm::YoloRect>& a, const std::vector<rm::YoloRect>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].box != b[i].box || a[i].class_id != b[i].class_id || a[i].color_id != b[i].color_id ||
+            a[i].confidence != b[i].confidence || a[i].four_points != b[i].four_points) return false;
+    }
+    return true;
+}
+
+// 原实现：按置信度排序后与所有保留框逐个计算 iou，仅用于对比耗时与结果
+static float legacyIoU(cv::Rect box1, cv::Rect box2) {
+    int x1 = std::max(box1.x, box2.x);
+    int y1 = std::max(box1.y, box2.y);
+    int x2 = std::min(box1.x + box1.width, box2.x + box2.width);
+    int y2 = std::min(box1.y + box1.height, box2.y + box2.height);
+    int w = std::max(0, x2 - x1 + 1);
+    int h = std::max(0, y2 - y1 + 1);
+    float over_area = w * h;
+    float union_area = box1.width * box1.height + box2.width * box2.height - over_area + 1e-5;
+    return over_area / union_area;
+}
+
+static void legacyNMS(std::vector<rm::YoloRect>& list) {
+    std::sort(list.begin(), list.end(), [](const rm::YoloRect& a, const rm::YoloRect& b) {
+        return a.confidence > b.confidence;
+    });
+    if (list.size() <= 1) return;
+    std::vector<rm::YoloRect> retained_list;
+    retained_list.push_back(list[0]);
+    for (size_t focus_index = 1; focus_index < list.size(); focus_index++) {
+        bool avaliable_rect = true;
+        for (size_t retained_index = 0; retained_index < retained_list.size(); retained_index++) {
+            if (legacyIoU(list[focus_index].box, retained_list[retained_index].box) > NMS_THRESHOLD) {
+                avaliable_rect = false;
+                break;
+            }
+        }
+        if (avaliable_rect) retained_list.push_back(list[focus_index]);
+    }
+    list = retained_list;
+}
+
+// 密集场景：大量四点框在若干簇附近抖动，置信度互不相同
+static std::vector<rm::YoloRect> makeScene(int num, std::mt19937& rng) {
+    std::uniform_real_distribution<float> unit(0.f, 1.f);
+    std::uniform_int_distribution<int> pos_x(0, INPUT_WIDTH - 80), pos_y(0, INPUT_HEIGHT - 40);
+    std::vector<cv::Point> clusters;
+    for (int i = 0; i < std::max(1, num / 20); i++) clusters.push_back(cv::Point(pos_x(rng), pos_y(rng)));
+
+    std::vector<rm::YoloRect> list(num);
+    for (int i = 0; i < num; i++) {
+        const cv::Point& c = clusters[i % clusters.size()];
+        int x = c.x + (int)(unit(rng) * 12), y = c.y + (int)(unit(rng) * 6);
+        int w = 50 + (int)(unit(rng) * 20), h = 20 + (int)(unit(rng) * 10);
+        list[i].box = cv::Rect(x, y, w, h);
+        list[i].four_points = {cv::Point2f(x, y), cv::Point2f(x + w, y), cv::Point2f(x, y + h), cv::Point2f(x + w, y + h)};
+        list[i].confidence = 0.5f + 0.5f * (float)i / num;
+        list[i].class_id = i % 9;
+        list[i].color_id = i % 2;
+    }
+    std::shuffle(list.begin(), list.end(), rng);
+    return list;
+}
+
+static bool sameResult(const std::vector<rm::YoloRect>& a, const std::vector<rm::YoloRect>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].box != b[i].box || a[i].class_id != b[i].class_id || a[i].confidence != b[i].confidence) return false;
+    }
+    return true;
+}
+
+int main() {
+    std::mt19937 rng(2024);
+    const std::vector<double> densities = {0.001, 0.005, 0.02};
+    const int loop = 200;
+
+    rm::NmsContext context(INPUT_WIDTH, INPUT_HEIGHT, INFER_SIZE, INFER_SIZE,
+                           CLASSES_NUM, CONFIDENCE_THRESHOLD, NMS_THRESHOLD);
+    LegacyGeometry geometry;
+    std::vector<float> output;
+
+    // 解码：与原实现逐行解码得到的推理框逐项比较，计时包含 nms
+    printf("%-6s %-8s %12s %12s %10s %8s\n", "model", "density", "legacy us", "context us", "decoded", "match");
+    for (const ModelLayout& layout : MODELS) {
+        int yolo_size = layout.head + CLASSES_NUM;
+        for (double density : densities) {
+            makeOutput(output, layout, yolo_size, density, rng);
+
+            std::vector<rm::YoloRect> decoded;
+            TimePoint t0 = getTime();
+            for (int i = 0; i < loop; i++) decoded = legacyDecode(output, layout, yolo_size, geometry);
+            TimePoint t1 = getTime();
+            for (int i = 0; i < loop; i++) runModel(context, layout, output.data());
+            TimePoint t2 = getTime();
+
+            context.setThreshold(CONFIDENCE_THRESHOLD, 2.f);
+            bool match = sameDecoded(legacyUnsuppressed(decoded, layout, CLASSES_NUM),
+                                     runModel(context, layout, output.data()));
+            context.setThreshold(CONFIDENCE_THRESHOLD, NMS_THRESHOLD);
+
+            printf("%-6s %-8.3f %12.1f %12.1f %10zu %8s\n", layout.name, density,
+                   getDoubleOfS(t0, t1) * 1e6 / loop, getDoubleOfS(t1, t2) * 1e6 / loop,
+                   decoded.size(), match ? "yes" : "no");
+        }
+    }
+
+    // nms 引擎：不区分类别时与原实现对比，其余模式只计时
+    const std::vector<int> scene_sizes = {100, 500, 2000, 8000};
+    const int scene_loop = 20;
+    printf("\n%-6s %12s %12s %12s %12s %12s %8s\n", "boxes", "legacy us", "agnostic us", "class us",
+           "color us", "fusion us", "match");
+    for (int num : scene_sizes) {
+        std::vector<rm::YoloRect> scene = makeScene(num, rng);
+        std::vector<rm::YoloRect> legacy, list;
+        double us[5] = {0, 0, 0, 0, 0};
+        bool match = true;
+
+        for (int i = 0; i < scene_loop; i++) {
+            legacy = scene;
+            TimePoint t0 = getTime();
+            legacyNMS(legacy);
+            TimePoint t1 = getTime();
+            us[0] += getDoubleOfS(t0, t1) * 1e6;
+
+            const rm::NmsMode modes[4] = {rm::NMS_MODE_AGNOSTIC, rm::NMS_MODE_CLASS, rm::NMS_MODE_COLOR, rm::NMS_MODE_AGNOSTIC};
+            for (int m = 0; m < 4; m++) {
+                context.setMode(modes[m], m == 3 ? rm::NMS_FUSION_WEIGHTED : rm::NMS_FUSION_NONE);
+                list = scene;
+                TimePoint t2 = getTime();
+                context.suppress(list);
+                TimePoint t3 = getTime();
+                us[m + 1] += getDoubleOfS(t2, t3) * 1e6;
+                if (m == 0 && !sameResult(legacy, list)) match = false;
+            }
+        }
+        context.setMode(rm::NMS_MODE_AGNOSTIC);
+        printf("%-6d %12.1f %12.1f %12.1f %12.1f %12.1f %8s\n", num, us[0] / scene_loop, us[1] / scene_loop,
+               us[2] / scene_loop, us[3] / scene_loop, us[4] / scene_loop, match ? "yes" : "no");
+    }
+    return 0;
+}
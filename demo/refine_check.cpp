@@ -0,0 +1,51 @@
+#include "pointer/pointer.h"
+#include <opencv2/opencv.hpp>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+// 竖直的蓝色灯条，x 为中心横坐标，y0/y1 为上下端
+static void drawLightbar(cv::Mat& image, int x, int y0, int y1) {
+    cv::rectangle(image, cv::Point(x - 3, y0), cv::Point(x + 3, y1), cv::Scalar(255, 160, 60), cv::FILLED);
+}
+
+// 装甲板框内有两组可以匹配的灯条对，refineArmors 应取中间的一组而不是靠近右下角的一组
+static bool check(const char* name, const cv::Rect& rect, int offset_x) {
+    cv::Mat image(480, 640, CV_8UC3, cv::Scalar::all(0));
+    // 装甲板中心处的灯条对
+    drawLightbar(image, offset_x + 290, 190, 230);
+    drawLightbar(image, offset_x + 350, 190, 230);
+    // 框内右下角的干扰灯条对
+    drawLightbar(image, offset_x + 385, 220, 260);
+    drawLightbar(image, offset_x + 430, 220, 260);
+
+    std::vector<rm::Armor> armors(1);
+    armors[0].color = rm::ARMOR_COLOR_BLUE;
+    armors[0].rect = rect;
+    rm::setArmorRectCenter(armors[0]);
+
+    rm::ArmorRefineParam param;
+    int success = rm::refineArmors(image, armors, param);
+
+    cv::Point2f mean(0, 0);
+    for (const cv::Point2f& point : armors[0].four_points) mean += point * 0.25f;
+    cv::Point2f expect(offset_x + 320, 210);
+    bool pass = (success == 1) && (armors[0].four_points.size() == 4) && (cv::norm(mean - expect) < 5.0);
+
+    printf("%-8s %8d %10.1f %10.1f %10.1f %10.1f %6s\n", name, success, mean.x, mean.y, expect.x, expect.y,
+           pass ? "ok" : "fail");
+    return pass;
+}
+
+// refineArmors 在同一 ROI 内存在两组灯条对时的回归检查
+//
+// 用法：refine_check
+int main() {
+    bool pass = true;
+    printf("%-8s %8s %10s %10s %10s %10s %6s\n", "case", "success", "mean x", "mean y", "expect x", "expect y", "");
+    pass &= check("inside", cv::Rect(200, 150, 240, 120), 0);
+    // 装甲板框超出图像左侧，ROI 的原点与 armor.rect 的原点不同
+    pass &= check("clipped", cv::Rect(-60, 150, 240, 120), -260);
+    printf("%s\n", pass ? "pass" : "fail");
+    return pass ? 0 : 1;
+}
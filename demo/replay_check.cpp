@@ -0,0 +1,116 @@
+#include "video/video.h"
+#include "video/recorder.h"
+#include "video/session.h"
+#include "utils/timer.h"
+#include <opencv2/opencv.hpp>
+#include <cstdio>
+#include <cstddef>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+static const int FRAME_NUM = 30;
+static const int CORRUPT_INDEX = 5;
+
+static cv::Mat makeImage(int index) {
+    cv::Mat image(48, 64, CV_8UC3);
+    cv::RNG rng(index + 1);
+    rng.fill(image, cv::RNG::UNIFORM, 0, 256);
+    return image;
+}
+
+// 经由 pushCameraFrame 与挂在相机上的录制器写出会话文件
+static bool record(const std::string& file_name, TimePoint base) {
+    rm::Camera camera;
+    camera.buffer = new rm::SwapBuffer<rm::Frame>();
+
+    rm::SessionRecorder recorder;
+    if (!recorder.open(file_name, false, FRAME_NUM)) return false;
+    rm::setCameraRecorder(&camera, &recorder);
+    for (int i = 0; i < FRAME_NUM; i++) {
+        std::shared_ptr<rm::Frame> frame = std::make_shared<rm::Frame>();
+        frame->image = std::make_shared<cv::Mat>(makeImage(i));
+        frame->time_point = base + std::chrono::milliseconds(10 * i);
+        frame->camera_id = 3;
+        frame->width = frame->image->cols;
+        frame->height = frame->image->rows;
+        frame->yaw = static_cast<float>(i);
+        frame->pitch = 0.5f * i;
+        frame->roll = 0;
+        rm::pushCameraFrame(&camera, frame);
+    }
+    rm::setCameraRecorder(&camera, nullptr);
+    recorder.close();
+    return recorder.getWriteCount() == FRAME_NUM && recorder.getDropCount() == 0;
+}
+
+// 把第 index 条记录的图像类型改为非法值，回放建立索引时应跳过该条
+static bool corrupt(const std::string& file_name, int index) {
+    int fd = open(file_name.c_str(), O_RDWR);
+    if (fd < 0) return false;
+    uint64_t offset = rm::SESSION_ALIGN;
+    bool ok = true;
+    for (int i = 0; i < index && ok; i++) {
+        rm::SessionRecord record;
+        ok = pread(fd, &record, sizeof(record), offset) == (ssize_t)sizeof(record);
+        offset += record.record_size;
+    }
+    int32_t type = 0x7FFFFFFF;
+    ok = ok && pwrite(fd, &type, sizeof(type), offset + offsetof(rm::SessionRecord, type)) == (ssize_t)sizeof(type);
+    close(fd);
+    return ok;
+}
+
+// 以最快速度回放一遍，逐帧与录制内容比较，返回收到的帧数，内容不符时返回 -1
+static int replayOnce(rm::Camera& camera, TimePoint base) {
+    if (!rm::runReplay(&camera, rm::REPLAY_SPEED_FAST)) return -1;
+
+    int count = 0;
+    int last = -1;
+    while (true) {
+        std::shared_ptr<rm::Frame> frame = camera.buffer->wait_pop(std::chrono::milliseconds(100));
+        if (frame == nullptr) {
+            if (!rm::isReplayFinished(&camera)) continue;
+            // 完成标志可能在最后一帧推入之后、上一次 pop 之前置位
+            frame = camera.buffer->pop();
+            if (frame == nullptr) break;
+        }
+
+        int index = static_cast<int>(std::lround(frame->yaw));
+        bool same = index > last && index != CORRUPT_INDEX && index < FRAME_NUM &&
+                    frame->camera_id == 3 && frame->pitch == 0.5f * index &&
+                    frame->time_point == base + std::chrono::milliseconds(10 * index) &&
+                    cv::norm(*(frame->image), makeImage(index), cv::NORM_INF) == 0;
+        if (!same) return -1;
+        last = index;
+        count++;
+    }
+    return count;
+}
+
+// 录制 -> 回放的往返检查，包括跳过损坏记录与回放结束后再次回放
+//
+// 用法：replay_check [file]
+int main(int argc, char** argv) {
+    std::string file_name = (argc > 1) ? argv[1] : "/tmp/openrm_replay_check.orm";
+    TimePoint base = getTime();
+
+    bool pass = record(file_name, base) && corrupt(file_name, CORRUPT_INDEX);
+    printf("%-10s %s\n", "record", pass ? "ok" : "fail");
+
+    rm::Camera camera;
+    bool opened = pass && rm::openReplay(&camera, file_name);
+    pass = opened;
+    for (int round = 0; round < 2 && pass; round++) {
+        int count = replayOnce(camera, base);
+        printf("%-10s %d %d/%d\n", "replay", round, count, FRAME_NUM - 1);
+        if (count != FRAME_NUM - 1) pass = false;
+    }
+    if (opened) rm::closeReplay(&camera);
+
+    unlink(file_name.c_str());
+    printf("%s\n", pass ? "pass" : "fail");
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,119 @@
+#include "structure/swapbuffer.hpp"
+#include "utils/timer.h"
+#include <algorithm>
+#include <atomic>
+#include <array>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// 原互斥锁双缓冲区，仅用于对比，buffer_index_ 的读写本身没有同步，与原实现相同
+template <class T>
+class LegacySwapBuffer {
+public:
+    LegacySwapBuffer() :
+        buffer_index_(0),
+        buffer_available_{false, false},
+        buffer_{std::make_shared<T>(), std::make_shared<T>()},
+        buffer_mutex_{std::make_shared<std::mutex>(), std::make_shared<std::mutex>()} {}
+
+    void push(std::shared_ptr<T> data) {
+        int push_index = !buffer_index_;
+        std::unique_lock<std::mutex> lock(*buffer_mutex_[push_index]);
+        buffer_[push_index] = data;
+        buffer_available_[push_index] = true;
+        buffer_index_ = push_index;
+    }
+
+    std::shared_ptr<T> pop() {
+        int pop_index = buffer_index_;
+        std::unique_lock<std::mutex> lock(*buffer_mutex_[pop_index]);
+        if (!buffer_available_[pop_index]) return nullptr;
+        std::shared_ptr<T> ret_data = buffer_[pop_index];
+        buffer_[pop_index] = std::make_shared<T>();
+        buffer_available_[pop_index] = false;
+        return ret_data;
+    }
+
+private:
+    int buffer_index_;
+    int buffer_available_[2];
+    std::shared_ptr<T> buffer_[2];
+    std::array<std::shared_ptr<std::mutex>, 2> buffer_mutex_;
+};
+
+// 推入后不再修改，消费者读取 seq 时不会与生产者竞争
+struct Payload {
+    Payload() : seq(0) {}
+    explicit Payload(uint64_t _seq) : seq(_seq) {}
+    const uint64_t seq;
+    char data[256];
+};
+
+// 生产者以最快速度推入，消费者忙等取出，统计双方吞吐与取出数据的新鲜度
+// 每次推入新分配一个数据，与采集线程每帧推入新帧相同，推入耗时包含这次分配
+template <class Buffer>
+static void bench(const char* name, int push_num) {
+    Buffer buffer;
+
+    std::atomic<bool> done(false);
+    uint64_t pop_num = 0, stale = 0, last_seq = 0;
+
+    TimePoint t0 = getTime();
+    std::thread consumer([&] {
+        while (!done.load(std::memory_order_relaxed)) {
+            std::shared_ptr<Payload> p = buffer.pop();
+            if (p == nullptr) continue;
+            if (p->seq <= last_seq) stale++;
+            last_seq = p->seq;
+            pop_num++;
+        }
+    });
+
+    for (int i = 1; i <= push_num; i++) {
+        buffer.push(std::make_shared<Payload>(i));
+    }
+    double push_s = getDoubleOfS(t0, getTime());
+    done = true;
+    consumer.join();
+
+    printf("%-12s push %8.1f ns/op  pop %9llu  stale %llu\n",
+           name, push_s * 1e9 / push_num,
+           (unsigned long long)pop_num, (unsigned long long)stale);
+}
+
+// 200fps 推入下的取帧延迟，对比忙等 pop 与阻塞 wait_pop
+static void bench_latency(int frame_num) {
+    rm::SwapBuffer<TimePoint> buffer;
+    std::atomic<bool> done(false);
+    double latency_sum = 0;
+    int latency_num = 0;
+
+    std::thread consumer([&] {
+        while (!done.load()) {
+            std::shared_ptr<TimePoint> p = buffer.wait_pop(std::chrono::milliseconds(50));
+            if (p == nullptr) continue;
+            latency_sum += getDoubleOfS(*p, getTime());
+            latency_num++;
+        }
+    });
+
+    for (int i = 0; i < frame_num; i++) {
+        std::this_thread::sleep_for(std::chrono::microseconds(5000));
+        buffer.push(std::make_shared<TimePoint>(getTime()));
+    }
+    done = true;
+    consumer.join();
+
+    printf("wait_pop     latency %.1f us over %d frames\n",
+           latency_sum * 1e6 / std::max(latency_num, 1), latency_num);
+}
+
+int main() {
+    const int push_num = 2000000;
+    bench<LegacySwapBuffer<Payload>>("legacy", push_num);
+    bench<rm::SwapBuffer<Payload>>("triple", push_num);
+    bench_latency(400);
+    return 0;
+}
@@ -0,0 +1,354 @@
+#include "video/video.h"
+#include "utils/timer.h"
+#include <opencv2/opencv.hpp>
+#include <linux/videodev2.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+static const int WIDTH = 320;
+static const int HEIGHT = 240;
+static const int FRAME_NUM = 120;
+static const size_t BUFFER_SIZE = 256 * 1024;
+
+// 帧间隔枚举的三种形式
+enum IntervalMode {
+    INTERVAL_DISCRETE,              // 1/30、1/60、1/120
+    INTERVAL_STEPWISE,              // 1/200 ~ 1/5
+    INTERVAL_NONE                   // 不支持 VIDIOC_ENUM_FRAMEINTERVALS
+};
+
+// 基于文件的模拟 UVC 设备，打开时从文件读入 MJPEG 帧，按驱动的入队出队规则逐帧输出
+struct FakeDevice {
+    std::mutex mutex;
+    int fd = -1;
+    IntervalMode interval_mode = INTERVAL_DISCRETE;
+    struct v4l2_fract timeperframe = {0, 0};
+
+    std::vector<std::vector<uchar>> frames;
+    size_t next_frame = 0;
+    uint32_t sequence = 0;
+
+    std::vector<std::vector<uchar>> memory;
+    std::deque<uint32_t> queued;
+    std::vector<bool> is_queued;
+    bool streaming = false;
+    bool stopped = false;
+
+    int late_qbuf = 0;              // STREAMOFF 或关闭之后仍在归还的缓冲区
+    int double_qbuf = 0;            // 重复归还同一缓冲区
+};
+
+static FakeDevice device;
+
+static int fake_open(const char* name, int flags) {
+    int fd = open(name, O_RDONLY);
+    if (fd < 0) return fd;
+    (void)flags;
+
+    std::lock_guard<std::mutex> lock(device.mutex);
+    device.fd = fd;
+    device.frames.clear();
+    std::ifstream file(name, std::ios::binary);
+    uint32_t length = 0;
+    while (file.read(reinterpret_cast<char*>(&length), sizeof(length))) {
+        std::vector<uchar> data(length);
+        if (!file.read(reinterpret_cast<char*>(data.data()), length)) break;
+        device.frames.push_back(std::move(data));
+    }
+    device.next_frame = 0;
+    device.sequence = 0;
+    device.streaming = false;
+    device.stopped = false;
+    return fd;
+}
+
+static int fake_close(int fd) {
+    std::lock_guard<std::mutex> lock(device.mutex);
+    if (fd == device.fd) {
+        device.fd = -1;
+        device.memory.clear();
+        device.queued.clear();
+        device.is_queued.clear();
+    }
+    return close(fd);
+}
+
+static int enum_interval(struct v4l2_frmivalenum* frmival) {
+    static const uint32_t denominators[3] = {30, 60, 120};
+    if (device.interval_mode == INTERVAL_DISCRETE && frmival->index < 3) {
+        frmival->type = V4L2_FRMIVAL_TYPE_DISCRETE;
+        frmival->discrete.numerator = 1;
+        frmival->discrete.denominator = denominators[frmival->index];
+        return 0;
+    }
+    if (device.interval_mode == INTERVAL_STEPWISE && frmival->index == 0) {
+        frmival->type = V4L2_FRMIVAL_TYPE_STEPWISE;
+        frmival->stepwise.min = {1, 200};
+        frmival->stepwise.max = {1, 5};
+        frmival->stepwise.step = {1, 1};
+        return 0;
+    }
+    errno = EINVAL;
+    return -1;
+}
+
+static int dequeue(struct v4l2_buffer* buffer) {
+    if (!device.streaming || device.queued.empty() || device.next_frame >= device.frames.size()) {
+        errno = EAGAIN;
+        return -1;
+    }
+    uint32_t index = device.queued.front();
+    device.queued.pop_front();
+    device.is_queued[index] = false;
+
+    const std::vector<uchar>& data = device.frames[device.next_frame++];
+    std::memcpy(device.memory[index].data(), data.data(), data.size());
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    buffer->index = index;
+    buffer->bytesused = static_cast<uint32_t>(data.size());
+    buffer->sequence = device.sequence++;
+    buffer->flags = V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC | V4L2_BUF_FLAG_TSTAMP_SRC_SOE;
+    buffer->timestamp.tv_sec = now.tv_sec;
+    buffer->timestamp.tv_usec = now.tv_nsec / 1000;
+    return 0;
+}
+
+static int fake_ioctl(int fd, unsigned long request, void* arg) {
+    std::lock_guard<std::mutex> lock(device.mutex);
+    if (fd != device.fd) {
+        if (request == VIDIOC_QBUF) device.late_qbuf++;
+        errno = EBADF;
+        return -1;
+    }
+
+    switch (request) {
+        case VIDIOC_S_FMT:
+        case VIDIOC_S_CTRL:
+            return 0;
+        case VIDIOC_ENUM_FRAMEINTERVALS:
+            return enum_interval(static_cast<struct v4l2_frmivalenum*>(arg));
+        case VIDIOC_S_PARM:
+            device.timeperframe = static_cast<struct v4l2_streamparm*>(arg)->parm.capture.timeperframe;
+            return 0;
+        case VIDIOC_REQBUFS: {
+            uint32_t count = static_cast<struct v4l2_requestbuffers*>(arg)->count;
+            device.memory.assign(count, std::vector<uchar>(BUFFER_SIZE));
+            device.is_queued.assign(count, false);
+            device.queued.clear();
+            return 0;
+        }
+        case VIDIOC_QUERYBUF: {
+            struct v4l2_buffer* buffer = static_cast<struct v4l2_buffer*>(arg);
+            buffer->length = BUFFER_SIZE;
+            buffer->m.offset = buffer->index * BUFFER_SIZE;
+            return 0;
+        }
+        case VIDIOC_QBUF: {
+            uint32_t index = static_cast<struct v4l2_buffer*>(arg)->index;
+            if (device.stopped) device.late_qbuf++;
+            if (device.is_queued[index]) {
+                device.double_qbuf++;
+            } else {
+                device.is_queued[index] = true;
+                device.queued.push_back(index);
+            }
+            return 0;
+        }
+        case VIDIOC_DQBUF:
+            return dequeue(static_cast<struct v4l2_buffer*>(arg));
+        case VIDIOC_STREAMON:
+            device.streaming = true;
+            device.stopped = false;
+            return 0;
+        case VIDIOC_STREAMOFF:
+            device.streaming = false;
+            device.stopped = true;
+            return 0;
+        default:
+            errno = ENOTTY;
+            return -1;
+    }
+}
+
+// 每 3ms 输出一帧
+static int fake_poll(struct pollfd* fds, nfds_t nfds, int timeout) {
+    (void)nfds;
+    (void)timeout;
+    std::this_thread::sleep_for(std::chrono::milliseconds(3));
+
+    std::lock_guard<std::mutex> lock(device.mutex);
+    bool ready = device.streaming && !device.queued.empty() && device.next_frame < device.frames.size();
+    fds[0].revents = ready ? POLLIN : 0;
+    return ready ? 1 : 0;
+}
+
+static void* fake_mmap(void* addr, size_t length, int prot, int flags, int fd, off_t offset) {
+    (void)addr;
+    (void)length;
+    (void)prot;
+    (void)flags;
+    (void)fd;
+    std::lock_guard<std::mutex> lock(device.mutex);
+    return device.memory[offset / BUFFER_SIZE].data();
+}
+
+static int fake_munmap(void* addr, size_t length) {
+    (void)addr;
+    (void)length;
+    return 0;
+}
+
+static const rm::UVCDeviceOps FAKE_DEVICE_OPS = {
+    fake_open, fake_close, fake_ioctl, fake_poll, fake_mmap, fake_munmap
+};
+
+// 帧序号以 8 个黑白方块编码在图像顶部，经 JPEG 压缩后仍可准确读出
+static cv::Mat makeImage(int index) {
+    cv::Mat image(HEIGHT, WIDTH, CV_8UC3, cv::Scalar(100, 120, 140));
+    for (int bit = 0; bit < 8; bit++) {
+        cv::Scalar color = ((index >> bit) & 1) ? cv::Scalar::all(255) : cv::Scalar::all(0);
+        cv::rectangle(image, cv::Rect(bit * 40, 0, 40, 40), color, cv::FILLED);
+    }
+    return image;
+}
+
+static int readIndex(const cv::Mat& image) {
+    int index = 0;
+    for (int bit = 0; bit < 8; bit++) {
+        cv::Scalar mean = cv::mean(image(cv::Rect(bit * 40 + 10, 10, 20, 20)));
+        if (mean[0] > 128) index |= 1 << bit;
+    }
+    return index;
+}
+
+static bool writeFrames(const std::string& file_name) {
+    std::ofstream file(file_name, std::ios::binary | std::ios::trunc);
+    for (int i = 0; i < FRAME_NUM; i++) {
+        std::vector<uchar> data;
+        cv::imencode(".jpg", makeImage(i), data, {cv::IMWRITE_JPEG_QUALITY, 95});
+        uint32_t length = static_cast<uint32_t>(data.size());
+        file.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        file.write(reinterpret_cast<const char*>(data.data()), length);
+    }
+    return static_cast<bool>(file);
+}
+
+// openUVC 按驱动枚举结果选取的帧间隔
+static bool checkInterval(const std::string& file_name, IntervalMode mode, unsigned int fps, uint32_t expect) {
+    device.interval_mode = mode;
+    device.timeperframe = {0, 0};
+    rm::Camera camera;
+    bool opened = rm::openUVC(&camera, WIDTH, HEIGHT, fps, 8, file_name,
+                              rm::CAPTURE_FORMAT_BGR, rm::UVC_PIXEL_FORMAT_MJPEG);
+    if (opened) rm::closeUVC(&camera);
+
+    bool pass = opened && device.timeperframe.numerator == 1 && device.timeperframe.denominator == expect;
+    printf("%-10s %6d %6u %6u/%u %6s\n", "interval", mode, fps,
+           device.timeperframe.numerator, device.timeperframe.denominator, pass ? "ok" : "fail");
+    return pass;
+}
+
+// 多线程解码后推出的帧须按序号递增，内容与文件中对应的帧一致
+static bool checkStream(const std::string& file_name) {
+    device.interval_mode = INTERVAL_DISCRETE;
+    rm::Camera camera;
+    if (!rm::openUVC(&camera, WIDTH, HEIGHT, 60, 8, file_name,
+                     rm::CAPTURE_FORMAT_BGR, rm::UVC_PIXEL_FORMAT_MJPEG)) {
+        return false;
+    }
+    if (!rm::runUVC(&camera, nullptr, 60)) {
+        rm::closeUVC(&camera);
+        return false;
+    }
+
+    int count = 0, last = -1;
+    bool ordered = true;
+    TimePoint last_time;
+    TimePoint deadline = getTime() + std::chrono::seconds(5);
+    while (getTime() < deadline) {
+        std::shared_ptr<rm::Frame> frame = camera.buffer->wait_pop(std::chrono::milliseconds(100));
+        if (frame == nullptr) {
+            std::lock_guard<std::mutex> lock(device.mutex);
+            if (device.next_frame >= device.frames.size()) break;
+            continue;
+        }
+        int index = readIndex(*(frame->image));
+        if (index <= last || (count > 0 && frame->time_point <= last_time)) ordered = false;
+        if (frame->width != WIDTH || frame->height != HEIGHT) ordered = false;
+        last = index;
+        last_time = frame->time_point;
+        count++;
+    }
+    rm::closeUVC(&camera);
+
+    // 三缓冲区只保留最新帧，消费者慢于生产者时会跳过部分帧
+    bool pass = ordered && count * 2 >= FRAME_NUM;
+    printf("%-10s %6s %6d %6d/%d %6s\n", "stream", "", last, count, FRAME_NUM, pass ? "ok" : "fail");
+    return pass;
+}
+
+// 采集中途关闭，排队中的解码任务须在 STREAMOFF 之前归还缓冲区
+static bool checkClose(const std::string& file_name) {
+    device.interval_mode = INTERVAL_DISCRETE;
+    bool pass = true;
+    for (int round = 0; round < 10 && pass; round++) {
+        rm::Camera camera;
+        if (!rm::openUVC(&camera, WIDTH, HEIGHT, 60, 8, file_name,
+                         rm::CAPTURE_FORMAT_BGR, rm::UVC_PIXEL_FORMAT_MJPEG)) {
+            return false;
+        }
+        if (!rm::runUVC(&camera, nullptr, 60)) {
+            rm::closeUVC(&camera);
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10 + 5 * round));
+        rm::closeUVC(&camera);
+
+        std::lock_guard<std::mutex> lock(device.mutex);
+        pass = device.late_qbuf == 0 && device.double_qbuf == 0;
+    }
+    printf("%-10s %6s %6d %6d/%d %6s\n", "close", "", device.late_qbuf, device.double_qbuf, 0, pass ? "ok" : "fail");
+    return pass;
+}
+
+// 基于文件的模拟设备上检查 openUVC 的 MJPEG 采集流程
+//
+// 用法：uvc_check [file]
+int main(int argc, char** argv) {
+    std::string file_name = (argc > 1) ? argv[1] : "/tmp/openrm_uvc_check.mjpeg";
+    if (!writeFrames(file_name)) {
+        printf("fail\n");
+        return 1;
+    }
+    rm::setUVCDeviceOps(&FAKE_DEVICE_OPS);
+
+    bool pass = true;
+    printf("%-10s %6s %6s %8s %6s\n", "case", "mode", "fps", "result", "");
+    pass &= checkInterval(file_name, INTERVAL_DISCRETE, 100, 120);
+    pass &= checkInterval(file_name, INTERVAL_DISCRETE, 50, 60);
+    pass &= checkInterval(file_name, INTERVAL_DISCRETE, 25, 30);
+    pass &= checkInterval(file_name, INTERVAL_STEPWISE, 90, 90);
+    pass &= checkInterval(file_name, INTERVAL_STEPWISE, 500, 200);
+    pass &= checkInterval(file_name, INTERVAL_STEPWISE, 2, 5);
+    pass &= checkInterval(file_name, INTERVAL_NONE, 100, 60);
+    pass &= checkInterval(file_name, INTERVAL_NONE, 25, 30);
+    pass &= checkStream(file_name);
+    pass &= checkClose(file_name);
+
+    rm::setUVCDeviceOps(nullptr);
+    unlink(file_name.c_str());
+    printf("%s\n", pass ? "pass" : "fail");
+    return pass ? 0 : 1;
+}
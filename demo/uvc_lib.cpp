@@ -21,15 +21,19 @@ int main() {
         tp.push_back(tp0);
     }
     
-    while(1) {
-        for (int i = 0; i < cameras.size(); i++) {
+    // 单线程通过epoll同时等待所有相机
+    int epoll_fd = rm::createCameraEpoll(cameras);
+    std::vector<int> ready_list;
 
-            std::shared_ptr<rm::Frame> frame;
-            frame = nullptr;
+    while(1) {
+        if (!rm::waitCameraEpoll(epoll_fd, ready_list, 100)) {
+            continue;
+        }
+        for (int i : ready_list) {
 
-            frame = cameras[i]->buffer->pop();
-            while (frame == nullptr) {
-                frame = cameras[i]->buffer->pop();
+            std::shared_ptr<rm::Frame> frame = cameras[i]->buffer->pop();
+            if (frame == nullptr) {
+                continue;
             }
 
             TimePoint tp1 = getTime();
@@ -41,4 +45,3 @@ int main() {
         }
     }
 }
-
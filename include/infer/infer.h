@@ -0,0 +1,96 @@
+#ifndef __OPENRM_INFER_INFER_H__
+#define __OPENRM_INFER_INFER_H__
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include <opencv2/dnn.hpp>
+#include "structure/enums.hpp"
+#include "infer/nms.h"
+
+namespace rm {
+
+struct InferParam {
+    int             infer_width     = 640;                          // 网络输入尺寸
+    int             infer_height    = 640;
+    int             bboxes_num      = 0;                            // 输出行数，为 0 时取模型输出的尺寸
+    int             struct_size     = 0;                            // 每行 float 数，为 0 时取模型输出的尺寸
+    int             thread_num      = 0;                            // 推理线程数，为 0 时按精度自动选择
+    InferPrecision  precision       = INFER_PRECISION_FP32;
+    std::string     output_name     = "output";                     // 与 TensorRT 流程使用的输出名相同
+};
+
+// 与 cuda/src/resize 中 generate_affine_matrix 相同的 letterbox 仿射矩阵，等比缩放并居中
+void getLetterboxMatrix(int src_width, int src_height, int dst_width, int dst_height,
+                        float input_to_infer[6], float infer_to_input[6]);
+
+// CPU 端 letterbox，输出与 warpaffine_kernel 逐位相同：NCHW、RGB、除以 255 的 float，空白处填充 pad
+// dst 至少为 3 * dst_width * dst_height 个 float，按行多线程执行
+bool letterbox(const cv::Mat& src, float* dst, int dst_width, int dst_height, uchar pad = 114);
+
+// 输入为 CV_8UC2 的 YUYV 图像，只转换插值用到的源图行，
+// 输出与 cvtColor(COLOR_YUV2BGR_YUYV) 后再 letterbox 逐位相同
+bool letterboxYUYV(const cv::Mat& src, float* dst, int dst_width, int dst_height, uchar pad = 114);
+
+// 推理后端接口
+//
+// 输入为任意尺寸的 BGR 图像或 CV_8UC2 的 YUYV 图像，按与 TensorRT 流程相同的 letterbox 方式缩放到网络输入尺寸，
+// 输出为与 detectOutput 拷回的主机端缓冲区相同排布的 float 数组，可直接交给 NmsContext 或 yoloArmorNMS_*
+class InferInterface {
+
+public:
+    InferInterface() {}
+    virtual ~InferInterface() {}
+
+    virtual bool init(const std::string& onnx_file, const InferParam& param) = 0;
+    virtual bool infer(const cv::Mat& image) = 0;
+    virtual const float* getOutput() const = 0;                     // 在下一次 infer 之前有效
+
+    int getBboxesNum() const { return bboxes_num_; }
+    int getStructSize() const { return struct_size_; }
+    int getInferWidth() const { return param_.infer_width; }
+    int getInferHeight() const { return param_.infer_height; }
+    int getInputWidth() const { return input_width_; }              // 最近一次 infer 的图像尺寸
+    int getInputHeight() const { return input_height_; }
+    const InferParam& getParam() const { return param_; }
+
+    // 按最近一次 infer 的图像尺寸设置 NmsContext 的几何参数
+    void setNmsGeometry(NmsContext& context) const {
+        context.setGeometry(input_width_, input_height_, param_.infer_width, param_.infer_height);
+    }
+
+protected:
+    InferParam param_;
+    int bboxes_num_ = 0;
+    int struct_size_ = 0;
+    int input_width_ = 0;
+    int input_height_ = 0;
+};
+
+// 基于 OpenCV DNN 的 CPU 后端
+//
+// FP16 需要 OpenCV 4.8 及以上的 DNN_TARGET_CPU_FP16，低版本回退为 FP32；INT8 直接加载量化后的 onnx
+// OpenCV 的线程数为进程全局设置，infer 期间切换为本后端的线程数，结束后恢复
+class DnnInfer : public InferInterface {
+
+public:
+    DnnInfer() {}
+    ~DnnInfer() {}
+
+    bool init(const std::string& onnx_file, const InferParam& param) override;
+    bool infer(const cv::Mat& image) override;
+    const float* getOutput() const override { return output_.empty() ? nullptr : output_.ptr<float>(); }
+
+    int getThreadNum() const { return thread_num_; }
+
+private:
+    bool preprocess(const cv::Mat& image);
+
+    cv::dnn::Net net_;
+    int thread_num_ = 1;
+    cv::Mat blob_;                                                  // NCHW，RGB，归一化到 0 ~ 1
+    cv::Mat output_;
+};
+
+}
+
+#endif
@@ -0,0 +1,152 @@
+#ifndef __OPENRM_INFER_NMS_H__
+#define __OPENRM_INFER_NMS_H__
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include "structure/stamp.hpp"
+#include "structure/enums.hpp"
+
+namespace rm {
+
+// yolo 输出后处理上下文，持有推理尺寸、阈值与可复用的结果存储
+//
+// 各 run 函数只读写本对象的成员，不同对象可在不同线程上同时使用
+// 返回的引用指向内部存储，在同一对象下一次 run 之前有效
+// 同一对象不可被多个线程同时使用，需要时每个线程或每路相机各持有一个
+// 默认 nms 不区分类别且不融合，与原实现结果相同
+class NmsContext {
+
+public:
+    NmsContext();
+    NmsContext(int input_width, int input_height, int infer_width, int infer_height,
+               int classes_num, float confidence_threshold, float nms_threshold);
+    ~NmsContext() {}
+
+    // 当前线程的上下文，供 yoloArmorNMS_* 兼容接口使用
+    static NmsContext& local();
+
+    void setGeometry(int input_width, int input_height, int infer_width, int infer_height);
+    void setThreshold(float confidence_threshold, float nms_threshold);
+    void setClassesNum(int classes_num) { classes_num_ = classes_num; }
+    void setMode(NmsMode mode, NmsFusion fusion = NMS_FUSION_NONE) { mode_ = mode; fusion_ = fusion; }
+
+    const std::vector<YoloRect>& runV5(const float* output_buffer, int bboxes_num);         // 4 + 1 + 类别数
+    const std::vector<YoloRect>& runFP(const float* output_buffer, int bboxes_num);         // 8 + 1 + 类别数
+    const std::vector<YoloRect>& runFPX(const float* output_buffer, int bboxes_num);        // 8 + 1 + 4 + 类别数
+    const std::vector<YoloRect>& runV5C36(const float* output_buffer, int bboxes_num);      // 4 + 1 + 36，类内与类间两次 nms
+
+    // 按置信度降序排列并做 nms，结果原地写回 list
+    void suppress(std::vector<YoloRect>& list);
+
+    const std::vector<YoloRect>& getResult() const { return result_; }
+    int getClassesNum() const { return classes_num_; }
+    float getConfidenceThreshold() const { return confidence_threshold_; }
+    float getNmsThreshold() const { return nms_threshold_; }
+    NmsMode getMode() const { return mode_; }
+    NmsFusion getFusion() const { return fusion_; }
+    float getRatio() const { return infer_to_input_ratio_; }
+    float getTopMove() const { return top_move_from_input_; }
+    float getLeftMove() const { return left_move_from_input_; }
+
+private:
+    cv::Rect boxToRect(const float* bbox) const;                            // 中心点与宽高
+    cv::Rect poseToRect(const float* pose) const;                           // 四点外接矩形
+    bool poseToPoints(const float* pose, std::vector<cv::Point2f>& four_points) const;
+    bool isPoseInside(const float* pose) const;                             // 四点是否远离推理图像边缘
+
+    int selectObjectness(const float* output_buffer, int bboxes_num, int yolo_size,
+                         int objectness_index);                             // 目标置信度不低于阈值的行号写入 candidate_
+    static int selectScore(const float* score, int num, float scale, float threshold,
+                           float& best_confidence);                         // score * scale 中超过阈值的最大者，无则返回 -1
+
+    float getIoU(int i, int j) const;                                       // boxes_ 中两框的 iou，与原实现逐位相同
+    void fuseBoxes(std::vector<YoloRect>& list);
+
+    // 参与 nms 的框，按列存放，右下角坐标计入框内
+    struct NmsBoxes {
+        std::vector<int> x1, y1, x2, y2;
+        std::vector<int> area;
+        std::vector<int> key;                                               // 只有 key 相同的框才相互抑制
+        std::vector<int> order;                                             // 按置信度降序排列的下标
+        std::vector<int> rank;                                              // 下标在 order 中的位置
+        std::vector<int> owner;                                             // 保留框为自身，被抑制的框为抑制它的最高置信度框
+    };
+
+    int classes_num_;
+    NmsMode mode_;
+    NmsFusion fusion_;
+    float confidence_threshold_;
+    float nms_threshold_;
+
+    int input_width_;
+    int input_height_;
+    int infer_width_;
+    int infer_height_;
+
+    float infer_to_input_ratio_;
+    float top_move_from_input_;
+    float left_move_from_input_;
+
+    std::vector<int> candidate_;                                            // 通过目标置信度筛选的行号
+    std::vector<YoloRect> result_;
+    std::vector<YoloRect> retained_;
+    std::vector<std::vector<YoloRect>> class_list_;
+
+    NmsBoxes boxes_;
+    std::vector<int> kept_;                                                 // 保留框下标，按置信度降序
+    std::vector<int> cell_head_;                                            // 网格内保留框链表
+    std::vector<int> entry_box_;
+    std::vector<int> entry_next_;
+    std::vector<double> fusion_sum_;                                        // 加权融合的累加量
+};
+
+std::vector<YoloRect> yoloArmorNMS_V5C36(
+    float* output_host_buffer,
+    int output_bboxes_num,
+    int armor_classes_num,
+    float confidence_threshold,
+    float nms_threshold,
+    int input_width,
+    int input_height,
+    int infer_width,
+    int infer_height
+);
+
+std::vector<YoloRect> yoloArmorNMS_V5(
+    float* output_host_buffer,
+    int output_bboxes_num,
+    int armor_classes_num,
+    float confidence_threshold,
+    float nms_threshold,
+    int input_width,
+    int input_height,
+    int infer_width,
+    int infer_height
+);
+
+std::vector<YoloRect> yoloArmorNMS_FP(
+    float* output_host_buffer,
+    int output_bboxes_num,
+    int classes_num,
+    float confidence_threshold,
+    float nms_threshold,
+    int input_width,
+    int input_height,
+    int infer_width,
+    int infer_height
+);
+
+std::vector<YoloRect> yoloArmorNMS_FPX(
+    float* output_host_buffer,
+    int output_bboxes_num,
+    int classes_num,
+    float confidence_threshold,
+    float nms_threshold,
+    int input_width,
+    int input_height,
+    int infer_width,
+    int infer_height
+);
+
+}
+
+#endif
@@ -11,6 +11,7 @@
 #include <kalman/kalman.h>
 
 #include <pointer/pointer.h>
+#include <pointer/histogram.h>
 
 #include <solver/solvepnp.h>
 #include <solver/ternary.hpp>
@@ -18,6 +19,11 @@
 #include <structure/cyclequeue.hpp>
 #include <structure/slidestd.hpp>
 #include <structure/swapbuffer.hpp>
+#include <structure/framepool.hpp>
+#include <structure/threadpool.hpp>
+#include <structure/arena.hpp>
+#include <structure/latency.hpp>
+#include <structure/posering.hpp>
 #include <structure/speedqueue.hpp>
 
 #include <structure/enums.hpp>
@@ -25,6 +31,8 @@
 #include <structure/camera.hpp>
 #include <structure/shm.hpp>
 
+#include <infer/infer.h>
+
 #include <tensorrt/tensorrt.h>
 
 #include <uniterm/uniterm.h>
@@ -36,5 +44,8 @@
 #include <utils/print.h>
 
 #include <video/video.h>
+#include <video/session.h>
+#include <video/recorder.h>
+#include <video/group.h>
 
 #endif
\ No newline at end of file
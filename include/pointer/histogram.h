@@ -0,0 +1,71 @@
+#ifndef __OPENRM_POINTER_HISTOGRAM_H__
+#define __OPENRM_POINTER_HISTOGRAM_H__
+#include <opencv2/opencv.hpp>
+#include <functional>
+#include <utility>
+#include <vector>
+#include <cstdint>
+
+namespace rm {
+
+// 256 级直方图统计与阈值计算
+//
+// 只统计给定 ROI 内的像素，BGR 图像按 COLOR_BGR2GRAY 的系数转为灰度或取单一通道
+// slide 将 ROI 移动到同一帧图像的新位置时，只增减新旧 ROI 的差异部分
+// 帧池会把同一块像素内存复用给新帧，仅凭图像地址无法区分新旧帧，因此 build 与 slide 须传入相同的非零帧号
+// 阈值计算所用的归一化结果与 cv::normalize(hist, hist, 0, 512, NORM_MINMAX) 一致
+// 仅在设置了订阅者时才绘制直方图图像并回调，检测流程中不产生任何绘制开销
+class Histogram {
+
+public:
+    typedef std::function<void(const cv::Mat&)> Subscriber;
+
+    Histogram() { reset(); }
+    ~Histogram() {}
+
+    void reset();
+
+    // channel 为 -1 时统计灰度，0/1/2 时统计 BGR 图像的对应通道，roi 为空时统计整幅图像
+    // frame_id 标识所统计的帧，如 transTimeToUll(frame.time_point)，为 0 时之后的 slide 均退化为 build
+    bool build(const cv::Mat& src, const cv::Rect& roi = cv::Rect(), int channel = -1, uint64_t frame_id = 0);
+    // 在与上一次 build/slide 相同的帧上移动 ROI，帧号、图像或其尺寸类型不同以及无重叠时退化为 build
+    bool slide(const cv::Mat& src, const cv::Rect& roi, uint64_t frame_id);
+
+    const int* getBins() const { return bins_; }
+    int getTotal() const { return total_; }
+    cv::Rect getROI() const { return roi_; }
+    void getNormalized(float normalized[256]) const;                        // 归一化到 0 ~ 512
+    void getNormalized(cv::Mat& histogram) const;                           // 与 getHistogram 输出格式相同
+
+    int getOtsuThreshold() const;                                           // 大津法阈值，与 cv::THRESH_OTSU 相同
+    std::pair<int, int> getDoublePeak() const;                              // 同 getHistDoublePeak
+    int getCutThreshold(int cut_threshold, int bios = 0, int end = 80) const;   // 同 getThresholdFromHist
+    int getPeakThreshold(int bios = 0) const;                               // 同 getThresholdFromHistPeak
+
+    void subscribe(const Subscriber& subscriber) { subscriber_ = subscriber; }
+    void unsubscribe() { subscriber_ = nullptr; }
+    bool isSubscribed() const { return static_cast<bool>(subscriber_); }
+
+    // 绘制直方图，vertical 为竖线位置，horizontal 为横线高度，小于 0 时不画
+    void render(cv::Mat& show_image, const std::vector<int>& vertical = std::vector<int>(),
+                int horizontal = -1) const;
+
+private:
+    void accumulate(const cv::Mat& src, const cv::Rect& rect, int sign);
+    void publish(const std::vector<int>& vertical, int horizontal = -1) const;
+
+    int bins_[256];
+    int total_;
+    int channel_;
+    cv::Rect roi_;
+    uint64_t frame_id_;                                                     // 上一次统计的帧号，以下各项一并用于判断 slide 是否可用
+    const uchar* data_;
+    cv::Size size_;
+    size_t step_;
+    int type_;
+    Subscriber subscriber_;
+};
+
+}
+
+#endif
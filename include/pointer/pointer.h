@@ -3,9 +3,40 @@
 
 #include "structure/stamp.hpp"
 #include "structure/enums.hpp"
+#include "structure/arena.hpp"
 
 namespace rm {
 
+// refineArmors 的参数，各项含义与逐个调用时对应函数的参数相同
+struct ArmorRefineParam {
+    double          threshold       = 0.5;                          // getGrayBinaryROI
+    ArmorColor      color           = ARMOR_COLOR_BLUE;
+    GrayScaleMethod gray_method     = GRAY_SCALE_METHOD_CVT;
+    BinaryMethod    binary_method   = BINARY_METHOD_MAX_MIN_RATIO;
+
+    double          min_rect_side   = 1.5;                          // getLightbarsFromContours
+    double          max_rect_side   = 15.0;
+    double          min_value_area  = 10.0;
+    double          min_ratio_area  = 0.4;
+    double          max_angle       = 45.0;
+    LightbarMethod  lightbar_method = LIGHTBAR_METHOD_CONTOUR;
+
+    double          max_ratio_length = 2.0;                         // getBestMatchedLightbarPair
+    double          max_ratio_area   = 4.0;
+    double          min_ratio_side   = 1.0;
+    double          max_ratio_side   = 5.0;
+    double          max_angle_diff   = 10.0;
+    double          max_angle_avg    = 45.0;
+    double          max_offset       = 1.0;
+
+    double          extend_dist     = 32.0;                         // findPointPairBarycenter
+    double          radius_ratio    = 0.1;
+    double          reset_radius    = 0.0;                          // resetArmorFourPoints，为 0 时跳过
+    BarycenterMethod barycenter_method = BARYCENTER_METHOD_MASK;
+
+    size_t          thread_num      = 0;                            // 线程池大小，仅首次调用生效，为 0 时自动选择
+};
+
 void getGrayScaleRGB(const cv::Mat& input, cv::Mat& gray, ArmorColor color);            // 通过RGB通道拆分获取灰度图
 void getGrayScaleHSV(const cv::Mat& input, cv::Mat& gray, ArmorColor color);            // 通过HSV限制色相获取灰度图
 void getGrayScaleCVT(const cv::Mat& input, cv::Mat& gray);                              // 将图像直接转换为灰度图
@@ -19,10 +50,36 @@ void getBinaryMaxMinRatio(const cv::Mat& input, cv::Mat& binary, double ratio);
 void getBinary(const cv::Mat& input, cv::Mat& binary, double threshold, 
                BinaryMethod method = BINARY_METHOD_MAX_MIN_RATIO);                      // 获取二值图统一接口
 
+bool getGrayBinary(const cv::Mat& input, cv::Mat& gray, cv::Mat& binary, double threshold,
+                   ArmorColor color = ARMOR_COLOR_BLUE,
+                   GrayScaleMethod gray_method = GRAY_SCALE_METHOD_CVT,
+                   BinaryMethod binary_method = BINARY_METHOD_MAX_MIN_RATIO);           // 一次遍历获取灰度图与二值图，结果同 getGrayScale + getBinary
+bool getGrayBinaryROI(const cv::Mat& src, const Armor& armor, cv::Mat& gray, cv::Mat& binary, double threshold,
+                      ArmorColor color = ARMOR_COLOR_BLUE,
+                      GrayScaleMethod gray_method = GRAY_SCALE_METHOD_CVT,
+                      BinaryMethod binary_method = BINARY_METHOD_MAX_MIN_RATIO);        // 仅在装甲板IOU矩形框内获取灰度图与二值图
+
+cv::Mat getGrayScale(const cv::Mat& input, FrameArena& arena, ArmorColor color = ARMOR_COLOR_BLUE,
+                     GrayScaleMethod method = GRAY_SCALE_METHOD_CVT);                   // 获取灰度图，结果位于arena内
+cv::Mat getBinary(const cv::Mat& input, FrameArena& arena, double threshold,
+                  BinaryMethod method = BINARY_METHOD_MAX_MIN_RATIO);                   // 获取二值图，结果位于arena内
+bool getGrayBinaryROI(const cv::Mat& src, const Armor& armor, FrameArena& arena,
+                      cv::Mat& gray, cv::Mat& binary, double threshold,
+                      ArmorColor color = ARMOR_COLOR_BLUE,
+                      GrayScaleMethod gray_method = GRAY_SCALE_METHOD_CVT,
+                      BinaryMethod binary_method = BINARY_METHOD_MAX_MIN_RATIO);        // 装甲板IOU区域的灰度图与二值图，结果位于arena内
+cv::Mat getHistogramEqualization(const cv::Mat& src, FrameArena& arena);               // 直方图均衡化，结果位于arena内
+
 ArmorID getArmorIDfromClass36(ArmorClass armor_class);                                    // 通过装甲板类别获取装甲板id
 ArmorColor getArmorColorFromClass36(ArmorClass armor_class);                              // 通过装甲板类别获取装甲板颜色
 ArmorColor getArmorColorFromHSV(const cv::Mat& src, const rm::LightbarPair &rect);      // 通过HSV获取装甲板颜色
 ArmorColor getArmorColorFromHSV(const cv::Mat& src, const rm::YoloRect& rect);          // 通过HSV获取装甲板颜色
+ArmorColor getArmorColorFromHSV(const cv::Mat& src, const cv::Rect& rect);             // 通过HSV获取矩形框扩展区域的颜色
+ArmorColor getArmorColorFromHSV(const cv::Mat& src, const cv::RotatedRect& rect);      // 通过HSV获取旋转矩形框扩展区域的颜色
+ArmorColor getArmorColorFromHSV(const cv::Mat& src, const rm::LightbarPair &rect,
+                                FrameArena& arena);                                     // 通过HSV获取装甲板颜色，HSV区域位于arena内
+ArmorColor getArmorColorFromHSV(const cv::Mat& src, const cv::Rect& rect,
+                                FrameArena& arena);                                     // 通过HSV获取矩形框扩展区域的颜色，HSV区域位于arena内
 ArmorColor getArmorColorFromRGB(const cv::Mat& src, const rm::LightbarPair &rect);      // 通过RBG获取装甲板颜色
 ArmorColor getArmorColorFromRGB(const cv::Mat& src, const rm::YoloRect& rect);          // 通过RBG获取装甲板颜色
 
@@ -54,6 +111,21 @@ void getLightbarsFromContours(const std::vector<std::vector<cv::Point>> &contour
                                  double min_value_area,
                                  double min_ratio_area,
                                  double max_angle);                                     // 从轮廓列表获取灯条列表
+void getLightbarsFromBinary(const cv::Mat& binary,
+                            std::vector<Lightbar> &lightbars,
+                            double min_rect_side,
+                            double max_rect_side,
+                            double min_value_area,
+                            double min_ratio_area,
+                            double max_angle);                                     // 从二值图连通域获取灯条列表，结果同 findContours(RETR_EXTERNAL) + getLightbarsFromContours
+void getLightbarsFromBinary(const cv::Mat& binary,
+                            FrameArena& arena,
+                            std::vector<Lightbar> &lightbars,
+                            double min_rect_side,
+                            double max_rect_side,
+                            double min_value_area,
+                            double min_ratio_area,
+                            double max_angle);                                     // 从二值图连通域获取灯条列表，中间结果位于arena内
 
 double getValueLengthLightbarPair(const Lightbar &lb1, const Lightbar &lb2);            // 获取两个灯条的长度平均值
 double getRatioLengthLightbarPair(const Lightbar &lb1, const Lightbar &lb2);            // 获取两个灯条的长度比, 大比小
@@ -84,6 +156,10 @@ bool getBestMatchedLightbarPair(const std::vector<rm::Lightbar>& lightbars,
 
 
 void getClampRect(const cv::Mat& src, cv::Rect& rect);                                  // 获取矩形框在图像内的边界检查
+bool getBarycenters(const cv::Mat& src, const std::vector<cv::Point>& centers, int radius,
+                    std::vector<cv::Point2f>& barycenters,
+                    ArmorColor color = ARMOR_COLOR_NONE,
+                    BarycenterMethod method = BARYCENTER_METHOD_MASK);                  // 批量获取圆形区域内的亮度重心，BGR图像按颜色取通道
 
 
 void showHistogram(cv::Mat& histogram, cv::Mat& ShowImage, int wid = 0, int len = 0);   // 返回直方图的图像版，wid和len为直方图的宽和高
@@ -102,7 +178,8 @@ void getHistogramEqualization(const cv::Mat& src, cv::Mat& dst);
 
 PointPair findPointPairBarycenter(Lightbar lightbar, const cv::Mat& gray,
                                   double extend_dist = 32.0,
-                                  double radius_ratio = 0.1);                           // 重心法获取灯条轮廓
+                                  double radius_ratio = 0.1,
+                                  BarycenterMethod method = BARYCENTER_METHOD_MASK);    // 重心法获取灯条轮廓
 void findCircleCenterFromContours(
     const std::vector<std::vector<cv::Point>>& contours,
     std::vector<cv::Point2f>& circles,
@@ -143,7 +220,8 @@ void setRelativeToAbsoluteTrans(Armor& armor);
 void setArmorFourPointsRelative(Armor& armor, const PointPair& pp0, const PointPair& pp1); // 设置装甲板四个顶点相对位置
 void setArmorFourPoints(Armor& armor, const PointPair& pp0, const PointPair& pp1);      // 设置装甲板四个顶点
 void setArmorSizeByPoints(Armor& armor, double ratio);                                  // 根据装甲板长宽比确定大小
-void resetArmorFourPoints(const cv::Mat& src, Armor& armor, double radius);             // 重置装甲板四个顶点
+void resetArmorFourPoints(const cv::Mat& src, Armor& armor, double radius,
+                          BarycenterMethod method = BARYCENTER_METHOD_MASK);            // 重置装甲板四个顶点
 
 void setLighterLUT(cv::Mat& src);                                                       // 使用 LUT 设置亮度略微提高
 void setLighterHSV(cv::Mat& src);                                                       // 使用 HSV 设置亮度略微提高
@@ -208,7 +286,14 @@ void initReprojection(double small_width, double small_height,
                       std::string big_path = "");                                      // 初始化重投影参数
 void setReprojection(const cv::Mat& src, cv::Mat& dst,
                      std::vector<cv::Point2f> four_points,
-                     rm::ArmorSize size);                                                // 设置重投影
+                     rm::ArmorSize size,
+                     bool use_pyramid = false);                                         // 设置重投影，dst 可与 src 相同
+void setReprojection(const cv::Mat& src, cv::Mat& dst,
+                     const std::vector<Armor>& armors,
+                     bool use_pyramid = false);                                         // 一次完成一帧内所有装甲板的重投影
+
+int refineArmors(const cv::Mat& src, std::vector<Armor>& armors,
+                 const ArmorRefineParam& param);                                        // 在线程池上并行地对各装甲板IOU区域提取四个顶点，返回成功个数
 
 
 }
@@ -0,0 +1,108 @@
+#ifndef __OPENRM_STRUCTURE_ARENA_HPP__
+#define __OPENRM_STRUCTURE_ARENA_HPP__
+#include <opencv2/opencv.hpp>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+namespace rm {
+
+// 单帧临时内存区，按顺序分配、在帧末统一 reset
+//
+// mat 返回的 cv::Mat 直接指向区内内存、不持有引用计数，reset 之后不可再使用
+// 若函数内部以不同的尺寸或类型调用 create，该 Mat 会改为从堆上重新分配，结果依然正确
+// 一帧内用量超过当前块时追加新块，reset 时合并为一个足够大的块，稳定后每帧不再向系统申请内存
+// 非线程安全，每个线程应使用各自的实例，local() 返回当前线程的实例
+class FrameArena {
+
+public:
+    explicit FrameArena(size_t block_size = (size_t)4 << 20) :
+        block_size_(std::max(block_size, (size_t)4096)), used_(0), peak_(0) {}
+    ~FrameArena() { release(); }
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    static FrameArena& local() {
+        static thread_local FrameArena arena;
+        return arena;
+    }
+
+    // 分配 bytes 字节，align 需为 2 的幂且不超过 64
+    void* allocate(size_t bytes, size_t align = 64) {
+        if (!blocks_.empty()) {
+            Block& block = blocks_.back();
+            size_t start = (block.used + align - 1) & ~(align - 1);
+            if (start + bytes <= block.size) {
+                block.used = start + bytes;
+                record(bytes);
+                return block.data + start;
+            }
+        }
+
+        Block block;
+        block.size = std::max(block_size_, bytes + align);
+        block.data = static_cast<uchar*>(cv::fastMalloc(block.size));
+        block.used = bytes;
+        blocks_.push_back(block);
+        record(bytes);
+        return block.data;
+    }
+
+    template <class T>
+    T* allocate(size_t num) {
+        return static_cast<T*>(allocate(num * sizeof(T), std::max(alignof(T), (size_t)16)));
+    }
+
+    cv::Mat mat(int rows, int cols, int type) {
+        if (rows <= 0 || cols <= 0) return cv::Mat(std::max(rows, 0), std::max(cols, 0), type);
+        size_t bytes = static_cast<size_t>(rows) * cols * CV_ELEM_SIZE(type);
+        return cv::Mat(rows, cols, type, allocate(bytes));
+    }
+    cv::Mat mat(const cv::Size& size, int type) { return mat(size.height, size.width, type); }
+
+    // 帧末调用，之前分配的内存全部失效
+    void reset() {
+        if (blocks_.size() > 1) {
+            size_t total = 0;
+            for (const auto& block : blocks_) total += block.size;
+            release();
+            block_size_ = std::max(block_size_, total);
+        }
+        if (!blocks_.empty()) blocks_.back().used = 0;
+        used_ = 0;
+    }
+
+    size_t getUsed() const { return used_; }                // 本帧已分配的字节数
+    size_t getPeak() const { return peak_; }                // 历史单帧最大用量
+    size_t getCapacity() const {
+        size_t total = 0;
+        for (const auto& block : blocks_) total += block.size;
+        return total;
+    }
+
+private:
+    struct Block {
+        uchar* data;
+        size_t size;
+        size_t used;
+    };
+
+    void record(size_t bytes) {
+        used_ += bytes;
+        peak_ = std::max(peak_, used_);
+    }
+
+    void release() {
+        for (auto& block : blocks_) cv::fastFree(block.data);
+        blocks_.clear();
+    }
+
+    size_t block_size_;                                     // 新块的最小容量
+    size_t used_;
+    size_t peak_;
+    std::vector<Block> blocks_;
+};
+
+}
+#endif
@@ -1,14 +1,23 @@
 #ifndef __OPENRM_STRUCTURE_CAMERA_HPP__
 #define __OPENRM_STRUCTURE_CAMERA_HPP__
 #include <structure/swapbuffer.hpp>
+#include <structure/framepool.hpp>
+#include <structure/threadpool.hpp>
+#include <structure/latency.hpp>
+#include <structure/posering.hpp>
 #include <structure/stamp.hpp>
 #include <opencv2/opencv.hpp>
 #include <Eigen/Dense>
 #include <cstdint>
+#include <atomic>
+#include <thread>
+#include <unistd.h>
 
 
 namespace rm {
 
+class SessionRecorder;
+
 class Camera {
 
 public:
@@ -19,12 +28,28 @@ public:
     int file_descriptor;                                    // 相机的文件描述符
 
     bool flip = false;                                      // 是否翻转图像
+    double exposure_us = 0;                                 // 曝光时间，单位微秒，用于计算曝光中点
+
+    PoseRing* pose_ring = nullptr;                          // 云台位姿历史，不归相机所有，可多相机共享
+    std::atomic<SessionRecorder*> recorder{nullptr};        // 会话录制器，不归相机所有，须通过 setCameraRecorder 挂上或摘下
+    std::atomic<int> recorder_pushing{0};                   // 正在使用 recorder 的推帧数
+    CaptureFormat capture_format = CAPTURE_FORMAT_BGR;      // 采集输出的图像格式
+
+    SwapBuffer<Frame>* buffer = nullptr;                    // 帧三缓冲区
+    int event_fd = -1;                                      // 新帧通知的eventfd，可被epoll监听
+    FramePool* frame_pool = nullptr;                        // 预分配的帧池
+
+    LatencyHistogram capture_latency;                       // 驱动时间戳到推帧的延迟分布
+    LatencyHistogram capture_jitter;                        // 相邻帧间隔变化量的分布
 
-    SwapBuffer<Frame>* buffer = nullptr;                    // 帧双缓冲区
+    std::thread capture_worker;                             // 采集线程
+    std::atomic<bool> capture_running{false};               // 采集线程运行标志，置 false 后线程在一个轮询周期内退出
 
     uint32_t capture_buffer_num = 0;                        // 图像读取的缓冲区数量
     uint32_t* capture_buffer_size = nullptr;                // 图像读取的缓冲区大小, 用于释放内存
     uint8_t** capture_buffer = nullptr;                     // 图像读取的缓冲区指针
+    UVCPixelFormat capture_pixel_format = UVC_PIXEL_FORMAT_YUYV;    // UVC传输的像素格式
+    ThreadPool* decode_pool = nullptr;                      // MJPEG解码线程池
 
     uint8_t* image_buffer = nullptr;                        // 图像读取的共享内存指针
 
@@ -39,9 +64,14 @@ public:
     Eigen::Matrix<double, 4, 4> Trans_pnp2head;             // 相机到云台的变换矩阵
     Eigen::Matrix<double, 3, 3> Rotate_pnp2head;            // 相机到云台的旋转矩阵
     ~Camera() {
+        capture_running = false;
+        if (capture_worker.joinable()) capture_worker.join();
         delete[] capture_buffer;
         delete[] capture_buffer_size;
+        delete decode_pool;
         delete buffer;
+        delete frame_pool;
+        if (event_fd >= 0) close(event_fd);
     }
 
 };
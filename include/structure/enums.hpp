@@ -22,6 +22,51 @@ enum FindPointMethod {
     FIND_POINT_METHOD_RECT_CROSSPOINT
 };
 
+enum LightbarMethod {
+    LIGHTBAR_METHOD_CONTOUR,        // findContours 后逐个轮廓计算最小外接矩形
+    LIGHTBAR_METHOD_COMPONENT       // 连通域标记与外接框预筛选，只对通过的最外层连通域提取轮廓
+};
+
+enum BarycenterMethod {
+    BARYCENTER_METHOD_REFERENCE,    // 逐像素 at<> 访问并用 cv::norm 判断是否在圆内，原实现
+    BARYCENTER_METHOD_MASK,         // 预计算各行圆内半宽，逐行指针累加，结果与原实现仅有浮点舍入差异
+    BARYCENTER_METHOD_INTEGRAL      // 在所有圆的外接区域上建行前缀和，每个圆只需 O(r) 次查表
+};
+
+enum NmsMode {
+    NMS_MODE_AGNOSTIC,              // 不区分类别，重叠的框相互抑制，原实现
+    NMS_MODE_CLASS,                 // 只抑制同类别的框
+    NMS_MODE_COLOR                  // 只抑制同颜色的框
+};
+
+enum NmsFusion {
+    NMS_FUSION_NONE,                // 舍弃被抑制的框
+    NMS_FUSION_WEIGHTED             // 被抑制的框按置信度加权平均到保留框的矩形与四点上
+};
+
+enum InferPrecision {
+    INFER_PRECISION_FP32,           // 单精度
+    INFER_PRECISION_FP16,           // 半精度，需要后端与硬件支持
+    INFER_PRECISION_INT8            // 量化模型，精度由 onnx 文件本身决定
+};
+
+enum CaptureFormat {
+    CAPTURE_FORMAT_BGR,             // 全分辨率BGR
+    CAPTURE_FORMAT_GRAY,            // 仅取YUYV的Y通道作为灰度图
+    CAPTURE_FORMAT_BGR_HALF         // 宽高各减半的BGR
+};
+
+enum UVCPixelFormat {
+    UVC_PIXEL_FORMAT_YUYV,          // 未压缩YUYV
+    UVC_PIXEL_FORMAT_MJPEG          // MJPEG压缩，需解码
+};
+
+enum ReplaySpeed {
+    REPLAY_SPEED_REALTIME,          // 按录制时的帧间隔回放
+    REPLAY_SPEED_FIXED,             // 按给定帧率回放
+    REPLAY_SPEED_FAST               // 消费者取走上一帧后立即推入下一帧
+};
+
 enum TeamColor {
     TEAM_COLOR_BLUE,
     TEAM_COLOR_RED
@@ -0,0 +1,111 @@
+#ifndef __OPENRM_STRUCTURE_FRAME_POOL_HPP__
+#define __OPENRM_STRUCTURE_FRAME_POOL_HPP__
+#include <structure/stamp.hpp>
+#include <opencv2/opencv.hpp>
+#include <memory>
+#include <vector>
+#include <atomic>
+#include <cstdint>
+
+namespace rm {
+
+// 固定容量的帧池，预分配 Frame 及其图像内存，供采集线程循环复用
+//
+// 池中每个槽位持有一个 shared_ptr<Frame>，acquire 返回其拷贝，槽位完全空闲时不产生任何内存分配
+// 当使用者释放最后一个拷贝后，槽位引用计数回到 1，该帧即自动回到池中
+// 使用者不应更换 frame->image 的尺寸或类型，否则该槽位会在下次取用时重新分配
+//
+// 槽位只在 Frame、image 指针与像素内存三者都不再被外部引用时原样复用
+// 使用者常以 cv::Mat img = *frame->image 取出图像后释放帧，此时像素仍被 img 引用，
+// 该槽位会换上新分配的图像，img 的内容不会被下一次采集覆盖
+//
+// acquire 仅允许单一生产者线程调用，计数器可在任意线程读取
+class FramePool {
+
+public:
+    FramePool(int width, int height, int type = CV_8UC3, size_t capacity = 8) :
+        width_(width), height_(height), type_(type), next_(0) {
+        slots_.resize(capacity);
+        for (auto& slot : slots_) slot = allocFrame();
+    }
+    ~FramePool() {}
+
+    FramePool(const FramePool&) = delete;
+    FramePool& operator=(const FramePool&) = delete;
+
+    // 取出一个空闲帧，池耗尽时临时分配一帧并计入未命中
+    std::shared_ptr<Frame> acquire() {
+        for (size_t n = 0; n < slots_.size(); n++) {
+            std::shared_ptr<Frame>& slot = slots_[next_];
+            next_ = (next_ + 1) % slots_.size();
+
+            if (slot.use_count() != 1) continue;
+            if (slot->image != nullptr && slot->image.use_count() != 1) continue;
+
+            // 与使用者释放引用时的 release 操作同步，之后才可改写该帧
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (!isImageValid(slot->image) || isPixelShared(*slot->image)) {
+                slot->image = std::make_shared<cv::Mat>(height_, width_, type_);
+                alloc_count_.fetch_add(1, std::memory_order_relaxed);
+            }
+            resetFrame(*slot);
+            return slot;
+        }
+
+        miss_count_.fetch_add(1, std::memory_order_relaxed);
+        return allocFrame();
+    }
+
+    int getWidth() const { return width_; }
+    int getHeight() const { return height_; }
+    int getType() const { return type_; }
+    size_t getCapacity() const { return slots_.size(); }
+
+    uint64_t getAllocCount() const { return alloc_count_.load(std::memory_order_relaxed); }     // 累计分配次数，稳态下不再增长
+    uint64_t getMissCount() const { return miss_count_.load(std::memory_order_relaxed); }       // 池耗尽的次数
+
+private:
+    std::shared_ptr<Frame> allocFrame() {
+        std::shared_ptr<Frame> frame = std::make_shared<Frame>();
+        frame->image = std::make_shared<cv::Mat>(height_, width_, type_);
+        frame->width = width_;
+        frame->height = height_;
+        alloc_count_.fetch_add(1, std::memory_order_relaxed);
+        return frame;
+    }
+
+    // 像素内存仍被 cv::Mat 的其他拷贝引用，由外部提供数据的 Mat 没有引用计数，视为独占
+    static bool isPixelShared(const cv::Mat& image) {
+        return image.u != nullptr && CV_XADD(&image.u->refcount, 0) != 1;
+    }
+
+    bool isImageValid(const std::shared_ptr<cv::Mat>& image) const {
+        return image != nullptr && image->rows == height_ && image->cols == width_ && image->type() == type_;
+    }
+
+    // 清空上一轮使用者写入的结果，保留容器容量以避免再次分配
+    void resetFrame(Frame& frame) const {
+        frame.width = width_;
+        frame.height = height_;
+        frame.yaw = 0;
+        frame.pitch = 0;
+        frame.roll = 0;
+        frame.locate = Locate();
+        frame.yolo_list.clear();
+        frame.armor_list.clear();
+        frame.target_list.clear();
+    }
+
+    int width_;
+    int height_;
+    int type_;
+    size_t next_;
+    std::vector<std::shared_ptr<Frame>> slots_;
+
+    std::atomic<uint64_t> alloc_count_{0};
+    std::atomic<uint64_t> miss_count_{0};
+};
+
+}
+#endif
@@ -0,0 +1,86 @@
+#ifndef __OPENRM_STRUCTURE_LATENCY_HPP__
+#define __OPENRM_STRUCTURE_LATENCY_HPP__
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+namespace rm {
+
+// 固定分桶的延迟直方图，单位为微秒
+//
+// 第 i 个桶统计 [i * bin_us, (i + 1) * bin_us) 内的样本，超出范围的样本计入最后一个桶
+// record 只做原子累加，可在采集线程中调用，统计接口可在任意线程读取
+class LatencyHistogram {
+
+public:
+    LatencyHistogram(double bin_us = 100.0, size_t bin_num = 500) :
+        bin_us_(bin_us), bin_num_(std::max(bin_num, (size_t)1)),
+        bins_(new std::atomic<uint64_t>[std::max(bin_num, (size_t)1)]) {
+        reset();
+    }
+    ~LatencyHistogram() {}
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    void record(double us) {
+        if (us < 0) us = 0;
+        size_t index = std::min(static_cast<size_t>(us / bin_us_), bin_num_ - 1);
+        bins_[index].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_us_.fetch_add(static_cast<uint64_t>(us), std::memory_order_relaxed);
+
+        uint64_t value = static_cast<uint64_t>(us);
+        uint64_t max_value = max_us_.load(std::memory_order_relaxed);
+        while (value > max_value && !max_us_.compare_exchange_weak(max_value, value, std::memory_order_relaxed));
+    }
+
+    void reset() {
+        for (size_t i = 0; i < bin_num_; i++) bins_[i].store(0, std::memory_order_relaxed);
+        count_.store(0, std::memory_order_relaxed);
+        sum_us_.store(0, std::memory_order_relaxed);
+        max_us_.store(0, std::memory_order_relaxed);
+    }
+
+    uint64_t getCount() const { return count_.load(std::memory_order_relaxed); }
+    double getMax() const { return static_cast<double>(max_us_.load(std::memory_order_relaxed)); }
+    double getMean() const {
+        uint64_t count = getCount();
+        return count > 0 ? static_cast<double>(sum_us_.load(std::memory_order_relaxed)) / count : 0.0;
+    }
+
+    // 分位数，返回所在桶的上边界，percent 取值 0~1
+    double getPercentile(double percent) const {
+        uint64_t count = getCount();
+        if (count == 0) return 0.0;
+        uint64_t target = static_cast<uint64_t>(std::min(std::max(percent, 0.0), 1.0) * count);
+        uint64_t sum = 0;
+        for (size_t i = 0; i < bin_num_; i++) {
+            sum += bins_[i].load(std::memory_order_relaxed);
+            if (sum > target) return (i + 1) * bin_us_;
+        }
+        return bin_num_ * bin_us_;
+    }
+
+    // 各桶计数的快照
+    std::vector<uint64_t> getBins() const {
+        std::vector<uint64_t> bins(bin_num_);
+        for (size_t i = 0; i < bin_num_; i++) bins[i] = bins_[i].load(std::memory_order_relaxed);
+        return bins;
+    }
+    double getBinWidth() const { return bin_us_; }
+
+private:
+    double bin_us_;                                         // 每个桶的宽度
+    size_t bin_num_;                                        // 桶数量
+    std::unique_ptr<std::atomic<uint64_t>[]> bins_;
+
+    std::atomic<uint64_t> count_;                           // 样本总数
+    std::atomic<uint64_t> sum_us_;                          // 样本总和
+    std::atomic<uint64_t> max_us_;                          // 样本最大值
+};
+
+}
+#endif
@@ -0,0 +1,198 @@
+#ifndef __OPENRM_STRUCTURE_POSE_RING_HPP__
+#define __OPENRM_STRUCTURE_POSE_RING_HPP__
+#include <structure/stamp.hpp>
+#include <utils/timer.h>
+#include <atomic>
+#include <memory>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+
+namespace rm {
+
+// 带时间戳的云台位姿，yaw / pitch / roll 单位为弧度
+struct PoseStamp {
+    TimePoint time_point;
+    Locate    locate;
+    float     yaw   = 0;
+    float     pitch = 0;
+    float     roll  = 0;
+};
+
+// 云台位姿历史环形缓冲区，单一写者（串口读取线程）、任意多个无锁读者（采集线程）
+//
+// 每个槽位用序列锁保护：写者先将序号置为奇数，写完数据后再置为偶数
+// 读者在前后两次读到相同的偶数序号时才认为拷贝有效，否则重试
+// 槽位序号同时编码了写入次数，读者据此确认读到的仍是期望的那一条记录
+class PoseRing {
+
+public:
+    explicit PoseRing(size_t capacity = 256) :
+        capacity_(std::max(capacity, (size_t)2)),
+        slots_(new Slot[std::max(capacity, (size_t)2)]),
+        write_count_(0) {}
+    ~PoseRing() {}
+
+    PoseRing(const PoseRing&) = delete;
+    PoseRing& operator=(const PoseRing&) = delete;
+
+    // 写入一条位姿，时间戳应单调递增
+    void push(const TimePoint& time_point, const Locate& locate, float yaw = 0, float pitch = 0, float roll = 0) {
+        uint64_t count = write_count_.load(std::memory_order_relaxed);
+        Slot& slot = slots_[count % capacity_];
+
+        slot.seq.store(count * 2 + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        slot.pose.time_point = time_point;
+        slot.pose.locate = locate;
+        slot.pose.yaw = yaw;
+        slot.pose.pitch = pitch;
+        slot.pose.roll = roll;
+
+        slot.seq.store(count * 2 + 2, std::memory_order_release);
+        write_count_.store(count + 1, std::memory_order_release);
+    }
+
+    // 取最新的一条位姿
+    bool latest(PoseStamp& pose) const {
+        while (true) {
+            uint64_t count = write_count_.load(std::memory_order_acquire);
+            if (count == 0) return false;
+            if (read(count - 1, pose)) return true;
+        }
+    }
+
+    // 查询时刻 t 的位姿，四元数球面插值，位置与欧拉角线性插值，其余字段取较近的一条
+    // t 超出历史范围时取最近的端点，缓冲区为空时返回 false
+    bool query(const TimePoint& t, PoseStamp& pose) const {
+        while (true) {
+            uint64_t count = write_count_.load(std::memory_order_acquire);
+            if (count == 0) return false;
+
+            // 位姿频率远高于帧率，从最新一条向前查找通常只需几步
+            uint64_t oldest = (count > capacity_ - 1) ? count - (capacity_ - 1) : 0;
+            PoseStamp newer, older;
+            if (!read(count - 1, newer)) continue;
+            if (newer.time_point <= t) {
+                pose = newer;
+                return true;
+            }
+
+            bool valid = true;
+            bool found = false;
+            for (uint64_t index = count - 1; index > oldest; index--) {
+                if (!read(index - 1, older)) {
+                    valid = false;
+                    break;
+                }
+                if (older.time_point <= t) {
+                    found = true;
+                    break;
+                }
+                newer = older;
+            }
+            if (!valid) continue;
+
+            if (!found) {
+                pose = newer;
+                return true;
+            }
+            interpolate(older, newer, t, pose);
+            return true;
+        }
+    }
+
+    size_t getCapacity() const { return capacity_; }
+    uint64_t getWriteCount() const { return write_count_.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> seq{0};
+        PoseStamp pose;
+    };
+
+    // 读取第 index 次写入的记录，记录已被覆盖或正在写入时返回 false
+    bool read(uint64_t index, PoseStamp& pose) const {
+        const Slot& slot = slots_[index % capacity_];
+        uint64_t expect = index * 2 + 2;
+        for (int retry = 0; retry < 8; retry++) {
+            uint64_t seq0 = slot.seq.load(std::memory_order_acquire);
+            if (seq0 > expect) return false;
+            if (seq0 != expect) continue;
+            pose = slot.pose;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            uint64_t seq1 = slot.seq.load(std::memory_order_relaxed);
+            if (seq0 == seq1) return true;
+        }
+        return false;
+    }
+
+    static void interpolate(const PoseStamp& a, const PoseStamp& b, const TimePoint& t, PoseStamp& pose) {
+        double span = getDoubleOfS(a.time_point, b.time_point);
+        double ratio = (span > 0) ? getDoubleOfS(a.time_point, t) / span : 0.0;
+        ratio = std::min(std::max(ratio, 0.0), 1.0);
+
+        pose = (ratio < 0.5) ? a : b;
+        pose.time_point = t;
+
+        slerp(a.locate, b.locate, ratio, pose.locate);
+        pose.locate.position_x = a.locate.position_x + (b.locate.position_x - a.locate.position_x) * ratio;
+        pose.locate.position_y = a.locate.position_y + (b.locate.position_y - a.locate.position_y) * ratio;
+        pose.locate.position_z = a.locate.position_z + (b.locate.position_z - a.locate.position_z) * ratio;
+
+        pose.yaw = lerpAngle(a.yaw, b.yaw, ratio);
+        pose.pitch = lerpAngle(a.pitch, b.pitch, ratio);
+        pose.roll = lerpAngle(a.roll, b.roll, ratio);
+    }
+
+    static void slerp(const Locate& a, const Locate& b, double ratio, Locate& out) {
+        double aw = a.orientation_w, ax = a.orientation_x, ay = a.orientation_y, az = a.orientation_z;
+        double bw = b.orientation_w, bx = b.orientation_x, by = b.orientation_y, bz = b.orientation_z;
+
+        // 取最短路径
+        double dot = aw * bw + ax * bx + ay * by + az * bz;
+        if (dot < 0) {
+            bw = -bw; bx = -bx; by = -by; bz = -bz;
+            dot = -dot;
+        }
+
+        double ka, kb;
+        if (dot > 0.9995) {
+            ka = 1.0 - ratio;
+            kb = ratio;
+        } else {
+            double theta = std::acos(std::min(dot, 1.0));
+            double sin_theta = std::sin(theta);
+            ka = std::sin((1.0 - ratio) * theta) / sin_theta;
+            kb = std::sin(ratio * theta) / sin_theta;
+        }
+
+        double w = ka * aw + kb * bw;
+        double x = ka * ax + kb * bx;
+        double y = ka * ay + kb * by;
+        double z = ka * az + kb * bz;
+        double norm = std::sqrt(w * w + x * x + y * y + z * z);
+        if (norm < 1e-12) {
+            out.orientation_w = aw; out.orientation_x = ax; out.orientation_y = ay; out.orientation_z = az;
+            return;
+        }
+        out.orientation_w = w / norm;
+        out.orientation_x = x / norm;
+        out.orientation_y = y / norm;
+        out.orientation_z = z / norm;
+    }
+
+    // 沿最短方向插值，避免在 ±pi 处跳变
+    static float lerpAngle(float a, float b, double ratio) {
+        double diff = std::remainder(static_cast<double>(b) - a, 2 * M_PI);
+        return static_cast<float>(std::remainder(a + diff * ratio, 2 * M_PI));
+    }
+
+    size_t capacity_;
+    std::unique_ptr<Slot[]> slots_;
+    std::atomic<uint64_t> write_count_;                     // 累计写入次数
+};
+
+}
+#endif
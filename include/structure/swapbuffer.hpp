@@ -2,56 +2,110 @@
 #define __OPENRM_STRUCTURE_SWAP_BUFFER_HPP__
 #include <memory>
 #include <mutex>
-#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <condition_variable>
 
 namespace rm {
 
+// 单生产者单消费者的"最新值"三缓冲区
+//
+// 生产者独占 back 槽，消费者独占 front 槽，middle 槽通过原子交换在两者之间传递
+// middle_ 的低两位为槽位索引，DIRTY_BIT 表示 middle 槽中有消费者尚未取走的新数据
+//
+//      push:  写 back 槽 -> exchange(back | DIRTY) -> 旧 middle 成为新的 back
+//      pop:   若 DIRTY 则 exchange(front) -> 旧 middle 成为新的 front，移出其数据
+//
+// push 与 pop 均为无等待操作且不分配内存，pop 在没有新数据时返回 nullptr
+// wait_pop 仅在消费者等待时才使用互斥锁与条件变量，生产者在无人等待时不会加锁
 template <class T>
 class SwapBuffer {
 
-public: 
-    SwapBuffer() :
-        buffer_index_(0),
-        buffer_available_{false, false},
-        buffer_{std::make_shared<T>(), std::make_shared<T>()},
-        buffer_mutex_{std::make_shared<std::mutex>(), std::make_shared<std::mutex>()} {}
+public:
+    SwapBuffer() : middle_(1), back_(0), front_(2), waiting_(0) {}
     ~SwapBuffer() {};
 
-    void push(std::shared_ptr<T> data) {
-        int push_index = !buffer_index_;
+    SwapBuffer(const SwapBuffer&) = delete;
+    SwapBuffer& operator=(const SwapBuffer&) = delete;
 
-        std::unique_lock<std::mutex> lock(*buffer_mutex_[push_index]);
+    // 生产者调用，覆盖尚未被取走的旧数据
+    void push(std::shared_ptr<T> data) {
+        buffer_[back_] = std::move(data);
+        uint8_t prev = middle_.exchange(back_ | DIRTY_BIT, std::memory_order_seq_cst);
+        back_ = prev & INDEX_MASK;
 
-        buffer_[push_index] = data;
+        // 上一帧未被取走，被新帧覆盖
+        if (prev & DIRTY_BIT) overwrite_count_.fetch_add(1, std::memory_order_relaxed);
+        push_count_.fetch_add(1, std::memory_order_relaxed);
 
-        buffer_available_[push_index] = true;
-        
-        buffer_index_ = push_index;
+        // 仅在有消费者阻塞等待时才加锁通知
+        if (waiting_.load(std::memory_order_seq_cst) > 0) {
+            std::lock_guard<std::mutex> lock(wait_mutex_);
+            wait_cond_.notify_all();
+        }
     }
 
+    // 消费者调用，无新数据时立即返回 nullptr
     std::shared_ptr<T> pop() {
-        int pop_index = buffer_index_;
+        if (!(middle_.load(std::memory_order_acquire) & DIRTY_BIT)) {
+            return nullptr;
+        }
+        uint8_t prev = middle_.exchange(front_, std::memory_order_acq_rel);
+        front_ = prev & INDEX_MASK;
+        return std::move(buffer_[front_]);
+    }
 
-        std::unique_lock<std::mutex> lock(*buffer_mutex_[pop_index]);
+    // 消费者调用，阻塞至有新数据或超时，超时返回 nullptr
+    template <class Rep, class Period>
+    std::shared_ptr<T> wait_pop(const std::chrono::duration<Rep, Period>& timeout) {
+        std::shared_ptr<T> data = pop();
+        if (data != nullptr) return data;
 
-        if (!buffer_available_[pop_index]) {
-            return nullptr;
+        std::unique_lock<std::mutex> lock(wait_mutex_);
+        waiting_.fetch_add(1, std::memory_order_seq_cst);
+        wait_cond_.wait_for(lock, timeout, [this] {
+            return (middle_.load(std::memory_order_seq_cst) & DIRTY_BIT) != 0;
+        });
+        waiting_.fetch_sub(1, std::memory_order_seq_cst);
+        lock.unlock();
+
+        return pop();
+    }
+
+    // 消费者调用，阻塞至有新数据
+    std::shared_ptr<T> wait_pop() {
+        std::shared_ptr<T> data = pop();
+        while (data == nullptr) {
+            data = wait_pop(std::chrono::milliseconds(100));
         }
-        
-        std::shared_ptr<T> ret_data = buffer_[pop_index];
-        buffer_[pop_index] = std::make_shared<T>();
-        
-        buffer_available_[pop_index] = false;
-        
-        return ret_data;
+        return data;
+    }
+
+    // 是否有尚未取走的新数据
+    bool available() const {
+        return (middle_.load(std::memory_order_acquire) & DIRTY_BIT) != 0;
     }
 
-private:   
-    int buffer_index_;
-    int buffer_available_[2];
-    std::shared_ptr<T> buffer_[2];
-    std::array<std::shared_ptr<std::mutex>, 2> buffer_mutex_;
+    uint64_t getPushCount() const { return push_count_.load(std::memory_order_relaxed); }
+    uint64_t getOverwriteCount() const { return overwrite_count_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr uint8_t INDEX_MASK = 0x3;
+    static constexpr uint8_t DIRTY_BIT = 0x4;
+
+    std::shared_ptr<T> buffer_[3];                          // 三个数据槽
+    std::atomic<uint8_t> middle_;                           // 中间槽索引与新数据标志
+    alignas(64) uint8_t back_;                              // 生产者独占的槽索引
+    alignas(64) uint8_t front_;                             // 消费者独占的槽索引
+
+    std::atomic<int> waiting_;                              // 阻塞等待的消费者数量
+    std::mutex wait_mutex_;
+    std::condition_variable wait_cond_;
+
+    std::atomic<uint64_t> push_count_{0};                   // 推入总数
+    std::atomic<uint64_t> overwrite_count_{0};              // 未被取走即被覆盖的数量
 };
 
 }
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,92 @@
+#ifndef __OPENRM_STRUCTURE_THREAD_POOL_HPP__
+#define __OPENRM_STRUCTURE_THREAD_POOL_HPP__
+#include <mutex>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <functional>
+#include <condition_variable>
+
+namespace rm {
+
+// 固定线程数的任务池，任务按提交顺序取出，但完成顺序不保证
+// 析构时会执行完队列中剩余的任务再退出
+class ThreadPool {
+
+public:
+    explicit ThreadPool(size_t thread_num) : stop_(false), active_(0) {
+        if (thread_num == 0) thread_num = 1;
+        for (size_t i = 0; i < thread_num; i++) {
+            workers_.emplace_back([this] { this->worker(); });
+        }
+    }
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        task_cond_.notify_all();
+        for (auto& worker : workers_) worker.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // 提交任务，不阻塞
+    void post(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.push_back(std::move(task));
+        }
+        task_cond_.notify_one();
+    }
+
+    // 尚未完成的任务数，包括排队中和执行中的任务
+    size_t pending() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return tasks_.size() + active_;
+    }
+
+    // 阻塞至所有已提交任务完成
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_cond_.wait(lock, [this] { return tasks_.empty() && active_ == 0; });
+    }
+
+    size_t size() const { return workers_.size(); }
+
+private:
+    void worker() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                task_cond_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+                if (stop_ && tasks_.empty()) return;
+                task = std::move(tasks_.front());
+                tasks_.pop_front();
+                active_++;
+            }
+
+            task();
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                active_--;
+                if (tasks_.empty() && active_ == 0) idle_cond_.notify_all();
+            }
+        }
+    }
+
+    bool stop_;
+    size_t active_;                                         // 执行中的任务数
+    std::deque<std::function<void()>> tasks_;               // 等待执行的任务
+    std::vector<std::thread> workers_;
+
+    std::mutex mutex_;
+    std::condition_variable task_cond_;
+    std::condition_variable idle_cond_;
+};
+
+}
+#endif
@@ -7,6 +7,7 @@
 #include <string>
 #include "structure/stamp.hpp"
 #include "tensorrt/logging.h"
+#include "infer/nms.h"
 
 namespace rm {
 
@@ -119,54 +120,6 @@ void memcpyClassifyBuffer(
     int channels = 3
 );
 
-std::vector<YoloRect> yoloArmorNMS_V5C36(
-    float* output_host_buffer,
-    int output_bboxes_num,
-    int armor_classes_num,
-    float confidence_threshold,
-    float nms_threshold,
-    int input_width,
-    int input_height,
-    int infer_width,
-    int infer_height
-);
-
-std::vector<YoloRect> yoloArmorNMS_V5(
-    float* output_host_buffer,
-    int output_bboxes_num,
-    int armor_classes_num,
-    float confidence_threshold,
-    float nms_threshold,
-    int input_width,
-    int input_height,
-    int infer_width,
-    int infer_height
-);
-
-std::vector<YoloRect> yoloArmorNMS_FP(
-    float* output_host_buffer,
-    int output_bboxes_num,
-    int classes_num,
-    float confidence_threshold,
-    float nms_threshold,
-    int input_width,
-    int input_height,
-    int infer_width,
-    int infer_height
-);
-
-std::vector<YoloRect> yoloArmorNMS_FPX(
-    float* output_host_buffer,
-    int output_bboxes_num,
-    int classes_num,
-    float confidence_threshold,
-    float nms_threshold,
-    int input_width,
-    int input_height,
-    int infer_width,
-    int infer_height
-);
-
 }
 
 #endif
\ No newline at end of file
@@ -49,6 +49,9 @@ unsigned long long transTimeToUll(const TimePoint& time);
 // 将unsigned long long转换为时间
 TimePoint transUlltoTime(unsigned long long time);
 
+// 将单调时钟(CLOCK_MONOTONIC)的纳秒时间戳转换为时间，用于驱动提供的硬件时间戳
+TimePoint transMonotonicToTime(long long monotonic_ns);
+
 // 通过时间获取字符串，可用于命名
 std::string getTimeStr();
 
@@ -0,0 +1,88 @@
+#ifndef __OPENRM_VIDEO_GROUP_H__
+#define __OPENRM_VIDEO_GROUP_H__
+#include <structure/camera.hpp>
+#include <structure/stamp.hpp>
+#include <structure/swapbuffer.hpp>
+#include <structure/latency.hpp>
+#include <memory>
+#include <vector>
+#include <deque>
+#include <atomic>
+#include <thread>
+#include <cstdint>
+#include <algorithm>
+
+namespace rm {
+
+// 同一时刻的多相机帧，frames 的顺序与加入相机组的顺序一致
+struct FrameBundle {
+    TimePoint                           time_point;     // 对齐的参考时刻
+    double                              skew_ms;        // 组内最早与最晚帧的时间差
+    std::vector<std::shared_ptr<Frame>> frames;
+};
+
+struct CameraGroupStat {
+    uint64_t receive_num;                               // 从相机缓冲区取到的帧数
+    uint64_t bundle_num;                                // 组成帧组的帧数
+    uint64_t drop_num;                                  // 未能匹配而丢弃的帧数
+    uint64_t overwrite_num;                             // 在相机缓冲区中被覆盖、未被取到的帧数
+    double   drop_rate;                                 // (drop + overwrite) / (receive + overwrite)
+};
+
+// 多相机同步采集组
+//
+// 相机需先由 openUVC/runUVC、openDaHeng 或 openReplay 启动后再加入组
+// 同步线程通过 epoll 等待各相机的新帧，按时间戳在容差内匹配，组成 FrameBundle 推入 bundles
+// 加入组后不应再直接从相机缓冲区取帧，关闭相机前需先调用 stop
+class CameraGroup {
+
+public:
+    explicit CameraGroup(double tolerance_ms = 5.0, size_t history = 4) :
+        tolerance_ms_(tolerance_ms), history_(std::max(history, (size_t)1)) {}
+    ~CameraGroup() { stop(); }
+
+    CameraGroup(const CameraGroup&) = delete;
+    CameraGroup& operator=(const CameraGroup&) = delete;
+
+    bool addCamera(Camera* camera);
+    bool start();
+    void stop();
+
+    SwapBuffer<FrameBundle> bundles;                    // 匹配完成的帧组
+
+    size_t size() const { return cameras_.size(); }
+    CameraGroupStat getStat(size_t index) const;
+    const LatencyHistogram& getSkew() const { return skew_hist_; }      // 帧组内时间差分布，单位微秒
+    uint64_t getBundleCount() const { return bundle_count_.load(std::memory_order_relaxed); }
+
+private:
+    struct Counter {
+        std::atomic<uint64_t> receive{0};
+        std::atomic<uint64_t> bundle{0};
+        std::atomic<uint64_t> drop{0};
+        std::atomic<uint64_t> overwrite{0};             // 同步线程读取的相机缓冲区覆盖数，相机关闭后仍可查询
+    };
+
+    void sync();
+    void match();
+    void dropFront(size_t index);
+    void updateOverwrite(size_t index);
+
+    double tolerance_ms_;
+    size_t history_;                                    // 每个相机最多缓存的待匹配帧数
+
+    std::vector<Camera*> cameras_;
+    std::vector<std::deque<std::shared_ptr<Frame>>> pending_;
+    std::vector<std::unique_ptr<Counter>> counters_;
+
+    int epoll_fd_ = -1;
+    std::thread sync_thread_;
+    std::atomic<bool> running_{false};
+
+    LatencyHistogram skew_hist_{50.0, 400};
+    std::atomic<uint64_t> bundle_count_{0};
+};
+
+}
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef __OPENRM_VIDEO_RECORDER_H__
+#define __OPENRM_VIDEO_RECORDER_H__
+#include <structure/stamp.hpp>
+#include <video/session.h>
+#include <condition_variable>
+#include <memory>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <cstdint>
+
+namespace rm {
+
+// 会话录制器，将帧按 video/session.h 的格式追加写入文件，供 openReplay 回放
+//
+// push 只把帧的引用放入固定长度的队列，由独立的写线程完成序列化、压缩与写盘
+// 队列已满时直接丢弃该帧并计数，不会阻塞采集线程
+// 写线程读取图像时帧可能已交给消费者，消费者不应在帧图像上绘制
+//
+// 每个录制器只接受一个生产者，通常挂在一个 Camera 的 recorder 上
+// close 会等待正在执行的 push 返回并写完已入队的帧，之后的 push 直接返回 false
+// 析构前须先以 setCameraRecorder(camera, nullptr) 摘下，否则采集线程可能访问已销毁的录制器
+class SessionRecorder {
+
+public:
+    SessionRecorder() {}
+    ~SessionRecorder() { close(); }
+
+    SessionRecorder(const SessionRecorder&) = delete;
+    SessionRecorder& operator=(const SessionRecorder&) = delete;
+
+    // compress 仅在编译时找到 lz4 时生效
+    bool open(const std::string& file_name, bool compress = false, size_t queue_size = 4);
+    void close();
+    bool isOpen() const { return running_.load(std::memory_order_acquire); }
+
+    // 生产者调用，非阻塞，丢帧时返回 false
+    bool push(std::shared_ptr<Frame> frame);
+
+    uint64_t getWriteCount() const { return write_count_.load(std::memory_order_relaxed); }   // 已写入的帧数
+    uint64_t getDropCount() const { return drop_count_.load(std::memory_order_relaxed); }     // 队列满被丢弃的帧数
+    uint64_t getWriteBytes() const { return write_bytes_.load(std::memory_order_relaxed); }   // 已写入的字节数
+
+private:
+    void writer();
+    bool writeFrame(const Frame& frame);
+    bool writeAligned(const uint8_t* data, size_t size);
+    bool reserveStaging(size_t size);
+
+    int fd_ = -1;
+    bool compress_ = false;
+    uint64_t offset_ = 0;                                   // 下一条记录的文件偏移
+
+    uint8_t* staging_ = nullptr;                            // 按 SESSION_ALIGN 对齐的写缓冲区
+    size_t staging_size_ = 0;
+
+    std::vector<std::shared_ptr<Frame>> queue_;             // 单生产者单消费者环形队列
+    std::atomic<size_t> head_{0};                           // 写线程读取位置
+    std::atomic<size_t> tail_{0};                           // 生产者写入位置
+
+    std::thread writer_thread_;
+    std::atomic<bool> running_{false};                      // 接受 push
+    std::atomic<bool> stopping_{false};                     // 不再有新帧入队，写线程写完队列后退出
+    std::atomic<int> pushing_{0};                           // 正在执行的 push 数
+    std::mutex wait_mutex_;
+    std::condition_variable wait_cond_;
+
+    std::atomic<uint64_t> write_count_{0};
+    std::atomic<uint64_t> drop_count_{0};
+    std::atomic<uint64_t> write_bytes_{0};
+};
+
+}
+
+#endif
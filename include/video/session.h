@@ -0,0 +1,65 @@
+#ifndef __OPENRM_VIDEO_SESSION_H__
+#define __OPENRM_VIDEO_SESSION_H__
+#include <structure/stamp.hpp>
+#include <type_traits>
+#include <cstdint>
+
+namespace rm {
+
+// 录制会话文件格式，由 SessionRecorder 写入、openReplay 以内存映射方式读取
+//
+//      [SessionHeader, 填充至 SESSION_ALIGN]
+//      [SessionRecord][图像数据][填充至 SESSION_ALIGN]
+//      [SessionRecord][图像数据][填充至 SESSION_ALIGN]
+//      ...
+//
+// 每条记录从对齐边界开始，便于以 O_DIRECT 直接写入，文件尾部可能存在全零填充
+// 图像数据按行连续存储，compression 非零时为压缩后的数据
+
+const uint32_t SESSION_MAGIC        = 0x53524D4F;   // "OMRS"
+const uint32_t SESSION_RECORD_MAGIC = 0x46524D4F;   // "OMRF"
+const uint32_t SESSION_VERSION      = 1;
+const uint32_t SESSION_ALIGN        = 4096;
+
+enum SessionCompression {
+    SESSION_COMPRESSION_NONE = 0,
+    SESSION_COMPRESSION_LZ4  = 1
+};
+
+struct SessionHeader {
+    uint32_t magic;                                         // SESSION_MAGIC
+    uint32_t version;                                       // SESSION_VERSION
+    uint32_t align;                                         // 记录对齐字节数
+    uint32_t reserved;
+    uint64_t create_time;                                   // 创建时间，transTimeToUll
+};
+
+struct SessionRecord {
+    uint32_t magic;                                         // SESSION_RECORD_MAGIC
+    uint32_t compression;                                   // SessionCompression
+    uint64_t record_size;                                   // 本条记录含填充的总字节数
+    uint64_t data_size;                                     // 图像数据实际存储的字节数
+    uint64_t raw_size;                                      // 图像解压后的字节数
+    uint64_t time_point;                                    // 帧时间戳，transTimeToUll
+    int32_t  camera_id;
+    int32_t  width;
+    int32_t  height;
+    int32_t  type;                                          // OpenCV 图像类型
+    float    yaw;
+    float    pitch;
+    float    roll;
+    uint32_t reserved;
+    Locate   locate;
+};
+
+static_assert(std::is_trivially_copyable<SessionHeader>::value, "SessionHeader must be trivially copyable");
+static_assert(std::is_trivially_copyable<SessionRecord>::value, "SessionRecord must be trivially copyable");
+
+// 对齐到 SESSION_ALIGN 的整数倍
+inline uint64_t alignSession(uint64_t size) {
+    return (size + SESSION_ALIGN - 1) / SESSION_ALIGN * SESSION_ALIGN;
+}
+
+}
+
+#endif
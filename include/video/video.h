@@ -4,7 +4,11 @@
 #include <structure/stamp.hpp>
 #include <vector>
 #include <string>
+#include <memory>
 #include <cstdint>
+#include <cstddef>
+#include <poll.h>
+#include <sys/types.h>
 
 namespace rm {
 
@@ -40,7 +44,9 @@ bool openUVC(
     unsigned int height = 1080,
     unsigned int fps = 60,
     unsigned int buffer_num = 8, 
-    std::string device_name = "/dev/video0"
+    std::string device_name = "/dev/video0",
+    CaptureFormat capture_format = CAPTURE_FORMAT_BGR,
+    UVCPixelFormat pixel_format = UVC_PIXEL_FORMAT_YUYV
 );
 
 bool setUVC(
@@ -56,6 +62,41 @@ bool setUVC(
 bool runUVC(Camera *camera, Locate* locate_ptr, int fps);
 bool closeUVC(Camera *camera);
 
+// UVC 设备使用的系统调用，默认直接转发到内核，测试时可替换为基于文件的模拟设备
+struct UVCDeviceOps {
+    int (*open_device)(const char* name, int flags);
+    int (*close_device)(int fd);
+    int (*ioctl_device)(int fd, unsigned long request, void* arg);
+    int (*poll_device)(struct pollfd* fds, nfds_t nfds, int timeout);
+    void* (*mmap_buffer)(void* addr, size_t length, int prot, int flags, int fd, off_t offset);
+    int (*munmap_buffer)(void* addr, size_t length);
+};
+// 须在打开相机之前设置，传入 nullptr 恢复默认
+void setUVCDeviceOps(const UVCDeviceOps* ops);
+
+
+bool openReplay(Camera *camera, std::string file_name);
+bool runReplay(
+    Camera *camera,
+    ReplaySpeed speed = REPLAY_SPEED_REALTIME,
+    double fps = 0.0,
+    bool loop = false);
+bool isReplayFinished(Camera *camera);
+bool closeReplay(Camera *camera);
+
+
+bool openCameraEvent(Camera *camera);
+void pushCameraFrame(Camera *camera, std::shared_ptr<Frame> frame);
+// 挂上或摘下会话录制器，返回时原录制器已不再被推帧使用，可以安全销毁
+void setCameraRecorder(Camera *camera, SessionRecorder *recorder);
+
+int createCameraEpoll(const std::vector<Camera*>& cameras);
+bool waitCameraEpoll(int epoll_fd, std::vector<int>& ready_list, int timeout_ms = -1);
+void closeCameraEpoll(int epoll_fd);
+
+// 查询曝光中点时刻的云台位姿，相机未设置 pose_ring 时返回 false
+bool getExposurePose(Camera *camera, const TimePoint& exposure_start, PoseStamp& pose);
+
 }
 
 #endif
\ No newline at end of file
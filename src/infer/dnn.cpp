@@ -0,0 +1,112 @@
+#include "infer/infer.h"
+#include "uniterm/uniterm.h"
+#include <algorithm>
+#include <unistd.h>
+
+using namespace rm;
+using namespace std;
+
+// 自动选择线程数：FP32 使用全部核心
+// FP16 与 INT8 的卷积核每次访存完成的计算更少，NUC 一类的小核数处理器上线程过多时先被内存带宽限制，取一半核心
+static int infer_thread_num(const InferParam& param) {
+    int cpu_num = max(cv::getNumberOfCPUs(), 1);
+    if (param.thread_num > 0) return param.thread_num;
+    if (param.precision == INFER_PRECISION_FP32) return cpu_num;
+    return max(cpu_num / 2, 1);
+}
+
+bool DnnInfer::init(const std::string& onnx_file, const InferParam& param) {
+    if (access(onnx_file.c_str(), F_OK) != 0) {
+        rm::message("Infer error at onnx file " + onnx_file, rm::MSG_ERROR);
+        return false;
+    }
+    if (param.infer_width <= 0 || param.infer_height <= 0) {
+        rm::message("Infer error at infer size", rm::MSG_ERROR);
+        return false;
+    }
+
+    try {
+        net_ = cv::dnn::readNetFromONNX(onnx_file);
+    } catch (const cv::Exception& e) {
+        rm::message("Infer error at reading onnx: " + string(e.what()), rm::MSG_ERROR);
+        return false;
+    }
+    if (net_.empty()) {
+        rm::message("Infer error at empty net", rm::MSG_ERROR);
+        return false;
+    }
+
+    param_ = param;
+    net_.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
+    if (param_.precision == INFER_PRECISION_FP16) {
+#if (CV_VERSION_MAJOR > 4) || (CV_VERSION_MAJOR == 4 && CV_VERSION_MINOR >= 8)
+        net_.setPreferableTarget(cv::dnn::DNN_TARGET_CPU_FP16);
+#else
+        rm::message("Infer FP16 needs OpenCV 4.8, fall back to FP32", rm::MSG_WARNING);
+        net_.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
+#endif
+    } else {
+        net_.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
+    }
+    thread_num_ = infer_thread_num(param_);
+
+    // 用一帧空白图像完成层的初始化与内存分配，并取得输出尺寸
+    cv::Mat warmup(param_.infer_height, param_.infer_width, CV_8UC3, cv::Scalar(114, 114, 114));
+    if (!infer(warmup)) return false;
+    input_width_ = 0;
+    input_height_ = 0;
+    return true;
+}
+
+// 与 cuda/src/resize 中的 warpaffine_kernel 输出相同，直接写入 blob，不再经过中间的 BGR 图像
+bool DnnInfer::preprocess(const cv::Mat& image) {
+    if (image.empty() || (image.type() != CV_8UC3 && image.type() != CV_8UC2)) {
+        rm::message("Infer error at input image", rm::MSG_ERROR);
+        return false;
+    }
+    input_width_ = image.cols;
+    input_height_ = image.rows;
+
+    const int dst_width = param_.infer_width;
+    const int dst_height = param_.infer_height;
+    const int size[4] = {1, 3, dst_height, dst_width};
+    blob_.create(4, size, CV_32F);
+    if (image.type() == CV_8UC2) return letterboxYUYV(image, blob_.ptr<float>(), dst_width, dst_height);
+    return letterbox(image, blob_.ptr<float>(), dst_width, dst_height);
+}
+
+bool DnnInfer::infer(const cv::Mat& image) {
+    if (net_.empty()) {
+        rm::message("Infer error at uninitialized net", rm::MSG_ERROR);
+        return false;
+    }
+    if (!preprocess(image)) return false;
+
+    int thread_num = cv::getNumThreads();
+    cv::setNumThreads(thread_num_);
+    try {
+        net_.setInput(blob_);
+        output_ = net_.forward(param_.output_name);
+    } catch (const cv::Exception& e) {
+        cv::setNumThreads(thread_num);
+        rm::message("Infer error at forward: " + string(e.what()), rm::MSG_ERROR);
+        return false;
+    }
+    cv::setNumThreads(thread_num);
+
+    // 输出为 [1, bboxes_num, struct_size]，与 TensorRT 引擎的输出排布相同
+    if (output_.dims != 3 || output_.size[0] != 1 || output_.type() != CV_32F || !output_.isContinuous()) {
+        rm::message("Infer error at output shape", rm::MSG_ERROR);
+        return false;
+    }
+    int bboxes_num = output_.size[1];
+    int struct_size = output_.size[2];
+    if ((param_.bboxes_num > 0 && param_.bboxes_num != bboxes_num) ||
+        (param_.struct_size > 0 && param_.struct_size != struct_size)) {
+        rm::message("Infer error at output size", rm::MSG_ERROR);
+        return false;
+    }
+    bboxes_num_ = bboxes_num;
+    struct_size_ = struct_size;
+    return true;
+}
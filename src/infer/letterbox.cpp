@@ -0,0 +1,243 @@
+#include "infer/infer.h"
+#include "uniterm/uniterm.h"
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+using namespace rm;
+using namespace std;
+
+// 与 cuda/src/resize/affine.cu 中 generate_affine_matrix 相同，包括 float 与 double 的混合运算顺序
+void rm::getLetterboxMatrix(int src_width, int src_height, int dst_width, int dst_height,
+                            float input_to_infer[6], float infer_to_input[6]) {
+    float scale_in = std::min(static_cast<float>(dst_height) / src_height, static_cast<float>(dst_width) / src_width);
+    float scale_out = 1.f / scale_in;
+
+    input_to_infer[0] = scale_in;
+    input_to_infer[1] = 0;
+    input_to_infer[2] = -scale_in * src_width * 0.5 + dst_width * 0.5;
+    input_to_infer[3] = 0;
+    input_to_infer[4] = scale_in;
+    input_to_infer[5] = -scale_in * src_height * 0.5 + dst_height * 0.5;
+
+    infer_to_input[0] = scale_out;
+    infer_to_input[1] = 0;
+    infer_to_input[2] = -scale_out * dst_width * 0.5 + src_width * 0.5;
+    infer_to_input[3] = 0;
+    infer_to_input[4] = scale_out;
+    infer_to_input[5] = -scale_out * dst_height * 0.5 + src_height * 0.5;
+}
+
+// warpaffine_kernel 中 w1 * v1 + w2 * v2 + w3 * v3 + w4 * v4 按 nvcc 默认 --fmad=true 收缩后的运算
+// 有硬件融合乘加时直接使用；否则 v 为 0 ~ 255 的整数，a * v 在 double 中精确，
+// 只有权重相差约 2^30 倍以上且恰好落在舍入中点时才会与融合乘加差一个舍入，实际图像中不会出现
+static inline float fused_mul_add(float a, float v, float c) {
+#if defined(__FMA__) || defined(__aarch64__) || defined(__ARM_FEATURE_FMA)
+    return std::fma(a, v, c);
+#else
+    return static_cast<float>(static_cast<double>(a) * v + c);
+#endif
+}
+
+static inline float bilinear(float w1, float w2, float w3, float w4, float v1, float v2, float v3, float v4) {
+    return fused_mul_add(w4, v4, fused_mul_add(w3, v3, fused_mul_add(w1, v1, w2 * v2)));
+}
+
+// 仿射矩阵只含缩放与平移，目标像素的源坐标在 x、y 方向上可分离，逐列、逐行预先计算
+// 各量的计算方式与核函数相同：src = m * d + m_z + 0.5f，low = floor(src)，l = src - low，h = 1 - l
+struct LetterboxAxis {
+    vector<int>   low;
+    vector<float> l;
+    vector<float> h;
+    vector<uchar> out;              // src <= -1 || src >= src_len，整个像素取填充值
+    vector<uchar> low_valid;        // low >= 0，整个像素越界时也为 0，不读取源图
+    vector<uchar> high_valid;       // low + 1 < src_len
+    int begin;                      // src 随 d 单调递增，未越界的目标像素为 [begin, end)
+    int end;
+
+    void build(float scale, float offset, int dst_len, int src_len) {
+        low.resize(dst_len);
+        l.resize(dst_len);
+        h.resize(dst_len);
+        out.resize(dst_len);
+        low_valid.resize(dst_len);
+        high_valid.resize(dst_len);
+        for (int d = 0; d < dst_len; d++) {
+            // m * d 单独舍入，避免编译器把后面的加法收缩成融合乘加
+            float src = std::fma(scale, static_cast<float>(d), 0.f) + offset + 0.5f;
+            int src_low = floorf(src);
+            low[d] = src_low;
+            l[d] = src - src_low;
+            h[d] = 1 - l[d];
+            out[d] = (src <= -1 || src >= src_len);
+            low_valid[d] = !out[d] && (src_low >= 0);
+            high_valid[d] = !out[d] && (src_low + 1 < src_len);
+        }
+        begin = 0;
+        while (begin < dst_len && out[begin]) begin++;
+        end = begin;
+        while (end < dst_len && !out[end]) end++;
+    }
+};
+
+struct LetterboxTable {
+    LetterboxAxis x;
+    LetterboxAxis y;
+    int src_width;
+    int src_height;
+    int dst_width;
+    int dst_height;
+    uchar pad;
+
+    void build(int _src_width, int _src_height, int _dst_width, int _dst_height, uchar _pad) {
+        src_width = _src_width;
+        src_height = _src_height;
+        dst_width = _dst_width;
+        dst_height = _dst_height;
+        pad = _pad;
+
+        float input_to_infer[6], infer_to_input[6];
+        getLetterboxMatrix(src_width, src_height, dst_width, dst_height, input_to_infer, infer_to_input);
+        x.build(infer_to_input[0], infer_to_input[2], dst_width, src_width);
+        y.build(infer_to_input[4], infer_to_input[5], dst_height, src_height);
+    }
+};
+
+// 写出一行，row_low 与 row_high 为源图第 low 与 low + 1 行的 BGR 数据，越界时为 nullptr，输出为 RGB 平面、除以 255
+// 先把四个邻点按通道收集成连续的 float，再逐通道做插值与归一化，后一步没有分支与间接访问，可由编译器向量化
+static void letterbox_row(const LetterboxTable& table, int dy, const uchar* row_low, const uchar* row_high, float* dst) {
+    const LetterboxAxis& ax = table.x;
+    const LetterboxAxis& ay = table.y;
+    const int width = table.dst_width;
+    const int area = table.dst_width * table.dst_height;
+    float* dst_plane[3] = {dst + (size_t)dy * width, dst + (size_t)dy * width + area, dst + (size_t)dy * width + area * 2};
+
+    const float pad_value = table.pad / 255.0f;
+    const uchar pad_pixel[3] = {table.pad, table.pad, table.pad};
+    if (ay.out[dy]) {
+        for (int k = 0; k < 3; k++) std::fill(dst_plane[k], dst_plane[k] + width, pad_value);
+        return;
+    }
+
+    // 越界的源图行用填充值代替
+    thread_local vector<uchar> pad_row;
+    if (!row_low || !row_high) {
+        pad_row.assign((size_t)table.src_width * 3, table.pad);
+        if (!row_low) row_low = pad_row.data();
+        if (!row_high) row_high = pad_row.data();
+    }
+
+    // 四个邻点按通道分别存放，v[k * 3 + c] 为第 k 个邻点的第 c 个通道
+    thread_local vector<float> buffer;
+    buffer.resize((size_t)width * 12);
+    float* v[12];
+    for (int k = 0; k < 12; k++) v[k] = buffer.data() + (size_t)width * k;
+
+    const float ly = ay.l[dy], hy = ay.h[dy];
+    const int* low = ax.low.data();
+    const uchar* low_valid = ax.low_valid.data();
+    const uchar* high_valid = ax.high_valid.data();
+    const float* lx = ax.l.data();
+    const float* hx = ax.h.data();
+
+    for (int dx = ax.begin; dx < ax.end; dx++) {
+        const uchar* p1 = low_valid[dx] ? row_low + low[dx] * 3 : pad_pixel;
+        const uchar* p2 = high_valid[dx] ? row_low + low[dx] * 3 + 3 : pad_pixel;
+        const uchar* p3 = low_valid[dx] ? row_high + low[dx] * 3 : pad_pixel;
+        const uchar* p4 = high_valid[dx] ? row_high + low[dx] * 3 + 3 : pad_pixel;
+        for (int c = 0; c < 3; c++) {
+            v[c][dx] = p1[c];
+            v[3 + c][dx] = p2[c];
+            v[6 + c][dx] = p3[c];
+            v[9 + c][dx] = p4[c];
+        }
+    }
+
+    for (int c = 0; c < 3; c++) {
+        const float* v1 = v[c];
+        const float* v2 = v[3 + c];
+        const float* v3 = v[6 + c];
+        const float* v4 = v[9 + c];
+
+        // bgr to rgb
+        float* plane = dst_plane[2 - c];
+        std::fill(plane, plane + ax.begin, pad_value);
+        for (int dx = ax.begin; dx < ax.end; dx++) {
+            const float w1 = hy * hx[dx], w2 = hy * lx[dx], w3 = ly * hx[dx], w4 = ly * lx[dx];
+            plane[dx] = bilinear(w1, w2, w3, w4, v1[dx], v2[dx], v3[dx], v4[dx]) / 255.0f;
+        }
+        std::fill(plane + ax.end, plane + width, pad_value);
+    }
+}
+
+static bool letterbox_check(const cv::Mat& src, int type, float* dst, int dst_width, int dst_height) {
+    if (src.empty() || src.type() != type) {
+        rm::message("Letterbox error at input type", rm::MSG_ERROR);
+        return false;
+    }
+    if (dst == nullptr || dst_width <= 0 || dst_height <= 0) {
+        rm::message("Letterbox error at output", rm::MSG_ERROR);
+        return false;
+    }
+    return true;
+}
+
+bool rm::letterbox(const cv::Mat& src, float* dst, int dst_width, int dst_height, uchar pad) {
+    if (!letterbox_check(src, CV_8UC3, dst, dst_width, dst_height)) return false;
+
+    // 线程局部的表只在调用线程中构建，工作线程通过引用访问
+    thread_local LetterboxTable cache;
+    cache.build(src.cols, src.rows, dst_width, dst_height, pad);
+    const LetterboxTable& table = cache;
+
+    cv::parallel_for_(cv::Range(0, dst_height), [&](const cv::Range& range) {
+        for (int dy = range.start; dy < range.end; dy++) {
+            int y_low = table.y.low[dy];
+            const uchar* row_low = table.y.low_valid[dy] ? src.ptr<uchar>(y_low) : nullptr;
+            const uchar* row_high = table.y.high_valid[dy] ? src.ptr<uchar>(y_low + 1) : nullptr;
+            letterbox_row(table, dy, row_low, row_high, dst);
+        }
+    });
+    return true;
+}
+
+// 只转换用到的源图行，每个线程缓存最近两行，相邻的目标行通常共用源图行
+// 转换使用 COLOR_YUV2BGR_YUYV，逐行转换与整幅转换的结果相同
+bool rm::letterboxYUYV(const cv::Mat& src, float* dst, int dst_width, int dst_height, uchar pad) {
+    if (!letterbox_check(src, CV_8UC2, dst, dst_width, dst_height)) return false;
+    if (src.cols % 2 != 0) {
+        rm::message("Letterbox error at YUYV width", rm::MSG_ERROR);
+        return false;
+    }
+
+    // 线程局部的表只在调用线程中构建，工作线程通过引用访问
+    thread_local LetterboxTable cache;
+    cache.build(src.cols, src.rows, dst_width, dst_height, pad);
+    const LetterboxTable& table = cache;
+
+    cv::parallel_for_(cv::Range(0, dst_height), [&](const cv::Range& range) {
+        // low 与 low + 1 奇偶性不同，按行号奇偶分别缓存
+        cv::Mat bgr[2];
+        int cached[2] = {-1, -1};
+        auto get_row = [&](int y) -> const uchar* {
+            int slot = y & 1;
+            if (cached[slot] != y) {
+                cv::cvtColor(src.row(y), bgr[slot], cv::COLOR_YUV2BGR_YUYV);
+                cached[slot] = y;
+            }
+            return bgr[slot].ptr<uchar>();
+        };
+
+        for (int dy = range.start; dy < range.end; dy++) {
+            if (table.y.out[dy]) {
+                letterbox_row(table, dy, nullptr, nullptr, dst);
+                continue;
+            }
+            int y_low = table.y.low[dy];
+            const uchar* row_low = table.y.low_valid[dy] ? get_row(y_low) : nullptr;
+            const uchar* row_high = table.y.high_valid[dy] ? get_row(y_low + 1) : nullptr;
+            letterbox_row(table, dy, row_low, row_high, dst);
+        }
+    });
+    return true;
+}
@@ -0,0 +1,521 @@
+#include "infer/nms.h"
+#include "uniterm/uniterm.h"
+#include <opencv2/core/hal/intrin.hpp>
+#include <cmath>
+#include <algorithm>
+#include <numeric>
+#include <climits>
+using namespace rm;
+
+// yolo输出的四点顺序：左上-左下-右下-右上
+struct alignas(float) yolofpRaw {
+    float pose[8];
+    float confidence;
+};
+
+struct alignas(float) yolov5Raw {
+    float bbox[4];
+    float confidence;
+};
+
+NmsContext::NmsContext() :
+    classes_num_(0),
+    mode_(NMS_MODE_AGNOSTIC),
+    fusion_(NMS_FUSION_NONE),
+    confidence_threshold_(0.f),
+    nms_threshold_(0.f),
+    input_width_(0),
+    input_height_(0),
+    infer_width_(0),
+    infer_height_(0),
+    infer_to_input_ratio_(1.f),
+    top_move_from_input_(0.f),
+    left_move_from_input_(0.f) {}
+
+NmsContext::NmsContext(int input_width, int input_height, int infer_width, int infer_height,
+                       int classes_num, float confidence_threshold, float nms_threshold) : NmsContext() {
+    setGeometry(input_width, input_height, infer_width, infer_height);
+    setThreshold(confidence_threshold, nms_threshold);
+    setClassesNum(classes_num);
+}
+
+NmsContext& NmsContext::local() {
+    static thread_local NmsContext context;
+    return context;
+}
+
+void NmsContext::setGeometry(int input_width, int input_height, int infer_width, int infer_height) {
+    input_width_ = input_width;
+    input_height_ = input_height;
+    infer_width_ = infer_width;
+    infer_height_ = infer_height;
+    if (infer_width_ <= 0 || infer_height_ <= 0) {
+        rm::message("NMS error at infer size", rm::MSG_ERROR);
+        infer_to_input_ratio_ = 1.f;
+        top_move_from_input_ = 0.f;
+        left_move_from_input_ = 0.f;
+        return;
+    }
+
+    float width_ratio = (float)input_width_ / (float)infer_width_;
+    float height_ratio = (float)input_height_ / (float)infer_height_;
+
+    top_move_from_input_ = ((float)infer_height_ * width_ratio - (float)input_height_) / 2.f;
+    left_move_from_input_ = ((float)infer_width_ * height_ratio - (float)input_width_) / 2.f;
+
+	// 根据缩放比最大的边设置缩放比例
+    if (width_ratio > height_ratio) {
+        infer_to_input_ratio_ = width_ratio;
+        left_move_from_input_ = 0;
+    } else {
+        infer_to_input_ratio_ = height_ratio;
+        top_move_from_input_ = 0;
+    }
+}
+
+void NmsContext::setThreshold(float confidence_threshold, float nms_threshold) {
+    confidence_threshold_ = confidence_threshold;
+    nms_threshold_ = nms_threshold;
+}
+
+// 从yolo推理的框，转化为opencv的Rect
+cv::Rect NmsContext::boxToRect(const float* bbox) const {
+    float x = bbox[0];
+    float y = bbox[1];
+    float w = bbox[2];
+    float h = bbox[3];
+
+    float half_w = w / 2.f;
+    float half_h = h / 2.f;
+
+    float left = (x - half_w) * infer_to_input_ratio_ - left_move_from_input_;
+    float top = (y - half_h) * infer_to_input_ratio_ - top_move_from_input_;
+    float right = (x + half_w) * infer_to_input_ratio_ - left_move_from_input_;
+    float bottom = (y + half_h) * infer_to_input_ratio_ - top_move_from_input_;
+
+    return cv::Rect(round(left), round(top), round(right - left), round(bottom - top));
+}
+
+// 从yolo推理的四点，转化为外接矩形
+cv::Rect NmsContext::poseToRect(const float* pose) const {
+    float min_x = std::min(std::min(pose[0], pose[2]), std::min(pose[4], pose[6]));
+    float max_x = std::max(std::max(pose[0], pose[2]), std::max(pose[4], pose[6]));
+    float min_y = std::min(std::min(pose[1], pose[3]), std::min(pose[5], pose[7]));
+    float max_y = std::max(std::max(pose[1], pose[3]), std::max(pose[5], pose[7]));
+
+    float left = min_x * infer_to_input_ratio_ - left_move_from_input_;
+    float top = min_y * infer_to_input_ratio_ - top_move_from_input_;
+    float width = (max_x - min_x) * infer_to_input_ratio_;
+    float height = (max_y - min_y) * infer_to_input_ratio_;
+
+    return cv::Rect(round(left), round(top), round(width), round(height));
+}
+
+// 四点转换到输入图像坐标，按 左上-右上-左下-右下 排列，任一点越界时返回 false
+bool NmsContext::poseToPoints(const float* pose, std::vector<cv::Point2f>& four_points) const {
+    const int x_index[4] = {0, 6, 2, 4};
+    const int y_index[4] = {1, 7, 3, 5};
+    four_points.clear();
+
+    for(int i = 0; i < 4; i++) {
+        double x = pose[x_index[i]] * infer_to_input_ratio_ - left_move_from_input_;
+        double y = pose[y_index[i]] * infer_to_input_ratio_ - top_move_from_input_;
+        if(x < 0 || x >= input_width_ || y < 0 || y >= input_height_) {
+            four_points.clear();
+            return false;
+        }
+        four_points.push_back(cv::Point2f(x, y));
+    }
+    return true;
+}
+
+// 对贴近边缘的框进行过滤
+bool NmsContext::isPoseInside(const float* pose) const {
+    for(int i = 0; i < 4; i++) {
+        if(pose[2 * i] < 1e-3 || pose[2 * i] > (infer_width_ - 1.001) ||
+           pose[2 * i + 1] < 1e-3 || pose[2 * i + 1] > (infer_height_ - 1.001)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 目标置信度位于每行第 objectness_index 个 float（矩形框为 4，四点为 8），按行跨步读取
+//
+// 绝大多数行在这一步被淘汰，因此先整列比较、无分支地压缩出候选行号，再只对候选行做类别筛选
+// 比较条件与原实现的 confidence < threshold 互补，NaN 同样保留
+int NmsContext::selectObjectness(const float* output_buffer, int bboxes_num, int yolo_size, int objectness_index) {
+    candidate_.resize(std::max(bboxes_num, 0));
+    int* candidate = candidate_.data();
+    int count = 0;
+    int i = 0;
+#if CV_SIMD
+    const int lanes = cv::v_float32::nlanes;
+    int offset[cv::v_float32::nlanes];
+    for (int k = 0; k < lanes; k++) offset[k] = k * yolo_size;
+    const cv::v_float32 threshold = cv::vx_setall_f32(confidence_threshold_);
+    for (; i <= bboxes_num - lanes; i += lanes) {
+        cv::v_float32 confidence = cv::v_lut(output_buffer + (size_t)i * yolo_size + objectness_index, offset);
+        int mask = cv::v_signmask(~(confidence < threshold));
+        for (int k = 0; k < lanes; k++) {
+            candidate[count] = i + k;
+            count += (mask >> k) & 1;
+        }
+    }
+#endif
+    for (; i < bboxes_num; i++) {
+        candidate[count] = i;
+        count += !(output_buffer[(size_t)i * yolo_size + objectness_index] < confidence_threshold_);
+    }
+    candidate_.resize(count);
+    return count;
+}
+
+// 与逐个比较 confidence > best && confidence > threshold 的结果相同：
+// 先求 score * scale 的最大值，再取第一个等于最大值的下标，NaN 不会被选中
+int NmsContext::selectScore(const float* score, int num, float scale, float threshold, float& best_confidence) {
+    float max_value = 0;
+    int i = 0;
+#if CV_SIMD
+    const int lanes = cv::v_float32::nlanes;
+    if (num >= lanes) {
+        const cv::v_float32 factor = cv::vx_setall_f32(scale);
+        const cv::v_float32 zero = cv::vx_setzero_f32();
+        cv::v_float32 max_vector = zero;
+        for (; i <= num - lanes; i += lanes) {
+            // v_max 在操作数为 NaN 时结果可能为 NaN，先把 NaN 置 0，与标量分支的 std::max 一样跳过
+            cv::v_float32 value = cv::vx_load(score + i) * factor;
+            value = cv::v_select(value != value, zero, value);
+            max_vector = cv::v_max(max_vector, value);
+        }
+        max_value = cv::v_reduce_max(max_vector);
+    }
+#endif
+    for (; i < num; i++) max_value = std::max(max_value, score[i] * scale);
+
+    best_confidence = 0;
+    if (!(max_value > 0) || !(max_value > threshold)) return -1;
+    for (i = 0; i < num; i++) {
+        if (score[i] * scale == max_value) break;
+    }
+    best_confidence = max_value;
+    return i;
+}
+
+// 与原 iou 计算相同，宽高带 +1，面积与 1e-5 的运算顺序也保持不变
+float NmsContext::getIoU(int i, int j) const {
+    const NmsBoxes& b = boxes_;
+    int w = std::max(0, std::min(b.x2[i], b.x2[j]) - std::max(b.x1[i], b.x1[j]) + 1);
+    int h = std::max(0, std::min(b.y2[i], b.y2[j]) - std::max(b.y1[i], b.y1[j]) + 1);
+
+    float over_area = w * h;
+    float union_area = b.area[i] + b.area[j] - over_area + 1e-5;
+    return over_area / union_area;
+}
+
+// 按置信度从高到低逐个决定去留，候选框只与其覆盖的网格内的保留框比较
+//
+// 网格边长不小于最大框边长，每个框最多覆盖 2x2 个网格；原 iou 计算的 +1 使相接的框也有重叠，
+// 因此以闭区间 [x1, x2] 划分网格，iou 可能大于阈值的两框一定落在同一网格内
+// 阈值为负时任意两框都会相互抑制，此时退化为单个网格
+// 只决定去留时找到一个即可停止；加权融合需要找到置信度最高的那个保留框
+void NmsContext::suppress(std::vector<YoloRect>& list) {
+    const int n = static_cast<int>(list.size());
+    if (n <= 1) return;
+
+    NmsBoxes& b = boxes_;
+    b.x1.resize(n); b.y1.resize(n); b.x2.resize(n); b.y2.resize(n);
+    b.area.resize(n); b.key.resize(n); b.order.resize(n); b.rank.resize(n); b.owner.resize(n);
+
+    int min_x = INT_MAX, min_y = INT_MAX, max_x = INT_MIN, max_y = INT_MIN, max_side = 0;
+    for (int i = 0; i < n; i++) {
+        const cv::Rect& box = list[i].box;
+        b.x1[i] = box.x;
+        b.y1[i] = box.y;
+        b.x2[i] = box.x + box.width;
+        b.y2[i] = box.y + box.height;
+        b.area[i] = box.width * box.height;
+        b.key[i] = (mode_ == NMS_MODE_CLASS) ? list[i].class_id :
+                   (mode_ == NMS_MODE_COLOR) ? list[i].color_id : 0;
+
+        min_x = std::min(min_x, std::min(b.x1[i], b.x2[i]));
+        min_y = std::min(min_y, std::min(b.y1[i], b.y2[i]));
+        max_x = std::max(max_x, std::max(b.x1[i], b.x2[i]));
+        max_y = std::max(max_y, std::max(b.y1[i], b.y2[i]));
+        max_side = std::max(max_side, std::max(std::abs(box.width), std::abs(box.height)));
+    }
+
+    // 按置信度降序，置信度相同时保持原顺序
+    std::iota(b.order.begin(), b.order.end(), 0);
+    std::stable_sort(b.order.begin(), b.order.end(), [&list](int l, int r) {
+        return list[l].confidence > list[r].confidence;
+    });
+    for (int r = 0; r < n; r++) b.rank[b.order[r]] = r;
+
+    // 网格数每边不超过 64
+    int span = std::max(max_x - min_x, max_y - min_y) + 1;
+    int cell = std::max(max_side + 1, span / 64 + 1);
+    if (nms_threshold_ < 0) cell = span;
+    int grid_w = (max_x - min_x) / cell + 1;
+    int grid_h = (max_y - min_y) / cell + 1;
+    cell_head_.assign((size_t)grid_w * grid_h, -1);
+    entry_box_.clear();
+    entry_next_.clear();
+    kept_.clear();
+
+    const bool find_best = (fusion_ == NMS_FUSION_WEIGHTED);
+    for (int r = 0; r < n; r++) {
+        int i = b.order[r];
+        int cx0 = (std::min(b.x1[i], b.x2[i]) - min_x) / cell;
+        int cx1 = (std::max(b.x1[i], b.x2[i]) - min_x) / cell;
+        int cy0 = (std::min(b.y1[i], b.y2[i]) - min_y) / cell;
+        int cy1 = (std::max(b.y1[i], b.y2[i]) - min_y) / cell;
+
+        // 已排序说明候选框置信度小于保留框，iou过大则舍弃候选框
+        int owner = -1;
+        for (int cy = cy0; cy <= cy1 && (owner < 0 || find_best); cy++) {
+            for (int cx = cx0; cx <= cx1 && (owner < 0 || find_best); cx++) {
+                for (int e = cell_head_[cy * grid_w + cx]; e >= 0; e = entry_next_[e]) {
+                    int j = entry_box_[e];
+                    if (b.key[j] != b.key[i]) continue;
+                    if (owner >= 0 && b.rank[j] >= b.rank[owner]) continue;
+                    if (getIoU(i, j) > nms_threshold_) {
+                        owner = j;
+                        if (!find_best) break;
+                    }
+                }
+            }
+        }
+        if (owner >= 0) {
+            b.owner[i] = owner;
+            continue;
+        }
+
+        // 保留候选框，并登记到其覆盖的所有网格
+        b.owner[i] = i;
+        kept_.push_back(i);
+        for (int cy = cy0; cy <= cy1; cy++) {
+            for (int cx = cx0; cx <= cx1; cx++) {
+                int c = cy * grid_w + cx;
+                entry_box_.push_back(i);
+                entry_next_.push_back(cell_head_[c]);
+                cell_head_[c] = static_cast<int>(entry_box_.size()) - 1;
+            }
+        }
+    }
+
+    if (find_best) fuseBoxes(list);
+
+    // 保留框移动到复用的存储中，不复制四点
+    retained_.clear();
+    retained_.reserve(kept_.size());
+    for (int i : kept_) retained_.push_back(std::move(list[i]));
+    list.swap(retained_);
+}
+
+// 每个保留框与被其抑制的框按置信度加权平均矩形四边与四点，保留框的置信度与类别不变
+// 四点只在两者都有四点时参与平均
+void NmsContext::fuseBoxes(std::vector<YoloRect>& list) {
+    const int n = static_cast<int>(list.size());
+    const int stride = 14;                  // 矩形权重、四边、四点权重、四点
+    const NmsBoxes& b = boxes_;
+    fusion_sum_.assign((size_t)n * stride, 0.0);
+
+    for (int i = 0; i < n; i++) {
+        int o = b.owner[i];
+        double w = list[i].confidence;
+        double* sum = fusion_sum_.data() + (size_t)o * stride;
+        sum[0] += w;
+        sum[1] += w * b.x1[i];
+        sum[2] += w * b.y1[i];
+        sum[3] += w * b.x2[i];
+        sum[4] += w * b.y2[i];
+        if (list[i].four_points.size() == 4 && list[o].four_points.size() == 4) {
+            sum[5] += w;
+            for (int k = 0; k < 4; k++) {
+                sum[6 + 2 * k] += w * list[i].four_points[k].x;
+                sum[7 + 2 * k] += w * list[i].four_points[k].y;
+            }
+        }
+    }
+
+    for (int i : kept_) {
+        const double* sum = fusion_sum_.data() + (size_t)i * stride;
+        if (sum[0] > 0) {
+            int x1 = cvRound(sum[1] / sum[0]);
+            int y1 = cvRound(sum[2] / sum[0]);
+            int x2 = cvRound(sum[3] / sum[0]);
+            int y2 = cvRound(sum[4] / sum[0]);
+            list[i].box = cv::Rect(x1, y1, x2 - x1, y2 - y1);
+        }
+        if (sum[5] > 0) {
+            for (int k = 0; k < 4; k++) {
+                list[i].four_points[k] = cv::Point2f(sum[6 + 2 * k] / sum[5], sum[7 + 2 * k] / sum[5]);
+            }
+        }
+    }
+}
+
+const std::vector<YoloRect>& NmsContext::runFP(const float* output_buffer, int bboxes_num) {
+    result_.clear();
+    const int yolo_size = 9 + classes_num_;
+    int candidate_num = selectObjectness(output_buffer, bboxes_num, yolo_size, 8);
+    result_.reserve(candidate_num);
+
+    for (int n = 0; n < candidate_num; n++) {
+
+        // 使用结构体截断Raw数据，其float长度为：8 + 1 + 类别数
+        const float* yolo_float = output_buffer + (size_t)candidate_[n] * yolo_size;
+        const yolofpRaw* yolo_raw = (const yolofpRaw*)yolo_float;
+        float iou_confidence = yolo_raw->confidence;
+
+        // 对所有类别的置信度进行筛选，找到最高的
+        float class_confidence;
+        int class_index = selectScore(yolo_float + 9, classes_num_, iou_confidence,
+                                      confidence_threshold_, class_confidence);
+        if(class_index == -1) continue;
+        if(!isPoseInside(yolo_raw->pose)) continue;
+
+        // 直接在结果中构造推理框，四点越界时撤回
+        result_.emplace_back();
+        YoloRect& detection_rect = result_.back();
+        if(!poseToPoints(yolo_raw->pose, detection_rect.four_points)) {
+            result_.pop_back();
+            continue;
+        }
+        detection_rect.confidence = class_confidence;
+        detection_rect.class_id = class_index;
+        detection_rect.box = poseToRect(yolo_raw->pose);
+    }
+
+    suppress(result_);
+    return result_;
+}
+
+const std::vector<YoloRect>& NmsContext::runV5(const float* output_buffer, int bboxes_num) {
+    result_.clear();
+    const int yolo_size = 5 + classes_num_;
+    int candidate_num = selectObjectness(output_buffer, bboxes_num, yolo_size, 4);
+    result_.reserve(candidate_num);
+
+    for (int n = 0; n < candidate_num; n++) {
+
+        // 使用结构体截断Raw数据，其float长度为：4 + 1 + 类别数
+        const float* yolo_float = output_buffer + (size_t)candidate_[n] * yolo_size;
+        const yolov5Raw* yolo_raw = (const yolov5Raw*)yolo_float;
+        float iou_confidence = yolo_raw->confidence;
+
+        // 对所有类别的置信度进行筛选，找到最高的
+        float class_confidence;
+        int class_index = selectScore(yolo_float + 5, classes_num_, iou_confidence,
+                                      confidence_threshold_, class_confidence);
+        if(class_index == -1) continue;
+
+        // 创建推理框结构体并赋值
+        result_.emplace_back();
+        YoloRect& detection_rect = result_.back();
+        detection_rect.confidence = class_confidence;
+        detection_rect.class_id = class_index;
+        detection_rect.box = boxToRect(yolo_raw->bbox);
+    }
+
+    suppress(result_);
+    return result_;
+}
+
+const std::vector<YoloRect>& NmsContext::runFPX(const float* output_buffer, int bboxes_num) {
+    result_.clear();
+    const int yolo_size = 9 + 4 + classes_num_;
+    int candidate_num = selectObjectness(output_buffer, bboxes_num, yolo_size, 8);
+    result_.reserve(candidate_num);
+
+    for (int n = 0; n < candidate_num; n++) {
+
+        // 使用结构体截断Raw数据，其float长度为：8 + 1 + 颜色数 + 类别数
+        const float* yolo_float = output_buffer + (size_t)candidate_[n] * yolo_size;
+        const yolofpRaw* yolo_raw = (const yolofpRaw*)yolo_float;
+        float iou_confidence = yolo_raw->confidence;
+
+        // 对颜色置信度进行筛选
+        float color_confidence;
+        int color_index = selectScore(yolo_float + 9, 3, iou_confidence,
+                                      confidence_threshold_, color_confidence);
+        if(color_index == -1) continue;
+
+        // 对所有类别的置信度进行筛选
+        float class_confidence;
+        int class_index = selectScore(yolo_float + 13, classes_num_, iou_confidence,
+                                      confidence_threshold_, class_confidence);
+        if(class_index == -1) continue;
+        if(!isPoseInside(yolo_raw->pose)) continue;
+
+        // 直接在结果中构造推理框，四点越界时撤回
+        result_.emplace_back();
+        YoloRect& detection_rect = result_.back();
+        if(!poseToPoints(yolo_raw->pose, detection_rect.four_points)) {
+            result_.pop_back();
+            continue;
+        }
+        detection_rect.confidence = class_confidence;
+        detection_rect.color_id = color_index;
+        detection_rect.class_id = class_index;
+        detection_rect.box = poseToRect(yolo_raw->pose);
+    }
+
+    suppress(result_);
+    return result_;
+}
+
+std::vector<YoloRect> rm::yoloArmorNMS_FP(
+    float* _output_host_buffer,
+    int _output_bboxes_num,
+    int _classes_num,
+    float _confidence_threshold,
+    float _nms_threshold,
+    int _input_width,
+    int _input_height,
+    int _infer_width,
+    int _infer_height
+) {
+    NmsContext& context = NmsContext::local();
+    context.setGeometry(_input_width, _input_height, _infer_width, _infer_height);
+    context.setThreshold(_confidence_threshold, _nms_threshold);
+    context.setClassesNum(_classes_num);
+    return context.runFP(_output_host_buffer, _output_bboxes_num);
+}
+
+std::vector<YoloRect> rm::yoloArmorNMS_V5(
+    float* _output_host_buffer,
+    int _output_bboxes_num,
+    int _classes_num,
+    float _confidence_threshold,
+    float _nms_threshold,
+    int _input_width,
+    int _input_height,
+    int _infer_width,
+    int _infer_height
+) {
+    NmsContext& context = NmsContext::local();
+    context.setGeometry(_input_width, _input_height, _infer_width, _infer_height);
+    context.setThreshold(_confidence_threshold, _nms_threshold);
+    context.setClassesNum(_classes_num);
+    return context.runV5(_output_host_buffer, _output_bboxes_num);
+}
+
+std::vector<YoloRect> rm::yoloArmorNMS_FPX(
+    float* _output_host_buffer,
+    int _output_bboxes_num,
+    int _classes_num,
+    float _confidence_threshold,
+    float _nms_threshold,
+    int _input_width,
+    int _input_height,
+    int _infer_width,
+    int _infer_height
+) {
+    NmsContext& context = NmsContext::local();
+    context.setGeometry(_input_width, _input_height, _infer_width, _infer_height);
+    context.setThreshold(_confidence_threshold, _nms_threshold);
+    context.setClassesNum(_classes_num);
+    return context.runFPX(_output_host_buffer, _output_bboxes_num);
+}
@@ -0,0 +1,157 @@
+#include "infer/nms.h"
+#include <algorithm>
+using namespace rm;
+
+struct alignas(float) yoloArmorRaw_V5C36 {
+    float bbox[4];
+    float confidence;
+    float classes[36];
+};
+
+static const int yolo_size = sizeof(yoloArmorRaw_V5C36) / sizeof(float);
+
+// 上古传承代码，计算iou交并比的函数
+static float nmstool_calcu_iou(const cv::Rect& box1, const cv::Rect& box2) {
+    // ----------------------------------> x
+    // |    A----------
+    // |    |         |
+    // |    |    B------------
+    // |    |    ||||||      |
+    // |    -----|----C      |
+    // |         |           |
+    // |         ------------D
+    // y
+    //
+    // A坐标：(box1.x, box1.y)
+    // B坐标：(box2.x, box2.y)
+    // 相交区域左上角坐标：(max(box1.x, box2.x), max(box1.y, box2.y))
+    // 右下角坐标同理
+
+    // 计算重叠区域左上角坐标
+    int x1 = std::max(box1.x, box2.x);
+    int y1 = std::max(box1.y, box2.y);
+    // 计算重叠区域右下角坐标
+    int x2 = std::min(box1.x + box1.width, box2.x + box2.width);
+    int y2 = std::min(box1.y + box1.height, box2.y + box2.height);
+    // 计算重叠区域宽高
+    int w = std::max(0, x2 - x1 + 1);
+    int h = std::max(0, y2 - y1 + 1);
+
+    // 计算交并集面积, 1e-5防止除以0
+    float over_area = w * h;
+    float union_area = box1.width * box1.height + box2.width * box2.height - over_area + 1e-5;
+
+    return over_area / union_area;
+}
+
+// 对不同类间的推理框进行nms
+static void nms_select_iou_class(const std::vector<std::vector<YoloRect>> &detection_class_list,
+                                 std::vector<YoloRect> &result_rect_list, float nms_threshold) {
+    // 清空用于返回的推理框vector
+    result_rect_list.clear();
+
+    // 对类进行遍历
+    for (size_t class_index = 0; class_index < detection_class_list.size(); class_index++) {
+        if (detection_class_list[class_index].empty()) {
+            continue;
+        }
+        
+        // 获取当前类的预选框数量，肯定会小于等于4，大于则说明错了
+        size_t rect_list_size = detection_class_list[class_index].size();
+        if(rect_list_size > 4ull) {
+            continue;
+        }
+
+        // 对类内所有框进行遍历
+        for (size_t rect_index = 0; rect_index < rect_list_size; rect_index++) {
+            const YoloRect& focus_rect = detection_class_list[class_index][rect_index];
+
+            // 如果返回框vector为空，直接推入
+            if (result_rect_list.empty()) {
+                result_rect_list.push_back(focus_rect);
+                continue;
+            }
+
+
+            // 对返回框进行遍历
+            bool avaliable_rect = true;
+            for (size_t result_index = 0; result_index < result_rect_list.size(); result_index++) {
+                const YoloRect& result_rect = result_rect_list[result_index];
+
+                // 由于上一个函数已经筛过同类的框了，所以如果同类则跳过
+                if (result_rect.class_id == focus_rect.class_id) {
+                    continue;
+                }
+
+                // 对不同类的返回框和关注框计算iou
+                float iou = nmstool_calcu_iou(focus_rect.box, result_rect.box);
+                
+                // 如果iou超过阈值则比较两者的置信度，保留大的
+                if (iou > nms_threshold) {
+                    if (focus_rect.confidence > result_rect.confidence) {
+                        result_rect_list[result_index] = focus_rect;
+                    }
+
+                    // 此时关注框已被换进去了，所以改完标签直接结束
+                    avaliable_rect = false;
+                    break;
+                }
+            }
+
+            // 根据标签决定是否推入
+            if (avaliable_rect) {
+                result_rect_list.push_back(focus_rect);
+            }
+        }
+    }
+}
+
+const std::vector<YoloRect>& NmsContext::runV5C36(const float* output_buffer, int bboxes_num) {
+    // 二维vector，第一层记录不同类，第二层是同类推理框，各层容量跨帧复用
+    const int classes_num = std::min(std::max(classes_num_, 0), 36);
+    class_list_.resize(classes_num);
+    for (auto& detection_rect_list : class_list_) detection_rect_list.clear();
+
+    // 先按目标置信度压缩出候选行，再对候选行筛选类别并按类别创建推理框对象
+    int candidate_num = selectObjectness(output_buffer, bboxes_num, yolo_size, 4);
+    for (int n = 0; n < candidate_num; n++) {
+        // 使用结构体截断Raw数据，其float长度为：4+1+类别数
+        const yoloArmorRaw_V5C36* yolo_raw = (const yoloArmorRaw_V5C36*)(output_buffer + (size_t)candidate_[n] * yolo_size);
+
+        // 对所有类别的置信度进行筛选，找到最高的
+        float class_confidence;
+        int class_index = selectScore(yolo_raw->classes, classes_num, 1.f, confidence_threshold_, class_confidence);
+        if(class_index == -1)
+            continue;
+
+        // 创建推理框结构体并赋值
+        class_list_[class_index].emplace_back();
+        YoloRect& detection_rect = class_list_[class_index].back();
+        detection_rect.confidence = yolo_raw->confidence;
+        detection_rect.class_id = class_index;
+        detection_rect.box = boxToRect(yolo_raw->bbox);
+    }
+
+    // 同类中按置信度排序后进行nms
+    for (auto& detection_rect_list : class_list_) suppress(detection_rect_list);
+    nms_select_iou_class(class_list_, result_, nms_threshold_);
+    return result_;
+}
+
+std::vector<YoloRect> rm::yoloArmorNMS_V5C36(
+    float* _output_host_buffer,
+    int _output_bboxes_num,
+    int _armor_classes_num,
+    float _confidence_threshold,
+    float _nms_threshold,
+    int _input_width,
+    int _input_height,
+    int _infer_width,
+    int _infer_height
+) {
+    NmsContext& context = NmsContext::local();
+    context.setGeometry(_input_width, _input_height, _infer_width, _infer_height);
+    context.setThreshold(_confidence_threshold, _nms_threshold);
+    context.setClassesNum(_armor_classes_num);
+    return context.runV5C36(_output_host_buffer, _output_bboxes_num);
+}
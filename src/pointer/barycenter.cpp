@@ -0,0 +1,198 @@
+#include "pointer/pointer.h"
+#include "uniterm/uniterm.h"
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+
+using namespace rm;
+using namespace std;
+
+// 亮度取值方式，BGR图像按装甲板颜色取通道
+enum BarycenterValue {
+    BARYCENTER_VALUE_GRAY,          // 单通道
+    BARYCENTER_VALUE_B,             // B
+    BARYCENTER_VALUE_R,             // R
+    BARYCENTER_VALUE_B_ADD_R        // B + R，不做饱和
+};
+
+template <int V>
+static inline int pixel_value(const uchar* row, int x) {
+    switch (V) {
+        case BARYCENTER_VALUE_GRAY: return row[x];
+        case BARYCENTER_VALUE_B: return row[x * 3];
+        case BARYCENTER_VALUE_R: return row[x * 3 + 2];
+        default: return row[x * 3] + row[x * 3 + 2];
+    }
+}
+
+// 半径为 radius 的圆在第 dy 行的半宽，即满足 w^2 + dy^2 <= r^2 的最大 w
+// 与 cv::norm(p - center) <= radius 判定的像素集合完全相同
+static const vector<int>& circle_half_width(int radius) {
+    thread_local vector<vector<int>> tables;
+    if (radius >= static_cast<int>(tables.size())) tables.resize(radius + 1);
+
+    vector<int>& table = tables[radius];
+    if (table.empty()) {
+        table.resize(radius + 1);
+        int w = radius;
+        for (int dy = 0; dy <= radius; dy++) {
+            while (w > 0 && w * w + dy * dy > radius * radius) w--;
+            table[dy] = w;
+        }
+    }
+    return table;
+}
+
+// 原实现，保留用于对比
+template <int V>
+static cv::Point2f barycenter_reference(const cv::Mat& src, const cv::Point& center, int radius) {
+    int x_min = max(center.x - radius, 0);
+    int x_max = min(center.x + radius, src.cols - 1);
+    int y_min = max(center.y - radius, 0);
+    int y_max = min(center.y + radius, src.rows - 1);
+
+    int gray_sum = 0;
+    cv::Point2f pixel_sum = cv::Point2f(0, 0);
+    for (int y = y_min; y <= y_max; ++y) {
+        for (int x = x_min; x <= x_max; ++x) {
+            if (cv::norm(cv::Point(x, y) - center) > radius) continue;
+            int gray_num = (V == BARYCENTER_VALUE_GRAY) ? static_cast<int>(src.at<uchar>(y, x)) :
+                           (V == BARYCENTER_VALUE_B) ? src.at<cv::Vec3b>(y, x)[0] :
+                           (V == BARYCENTER_VALUE_R) ? src.at<cv::Vec3b>(y, x)[2] :
+                           src.at<cv::Vec3b>(y, x)[0] + src.at<cv::Vec3b>(y, x)[2];
+            pixel_sum += cv::Point2f(x, y) * gray_num;
+            gray_sum += gray_num;
+        }
+    }
+    return pixel_sum / gray_sum;
+}
+
+template <int V>
+static cv::Point2f barycenter_mask(const cv::Mat& src, const cv::Point& center, int radius) {
+    const vector<int>& half = circle_half_width(radius);
+    int y_min = max(center.y - radius, 0);
+    int y_max = min(center.y + radius, src.rows - 1);
+
+    int64_t sum = 0, sum_x = 0, sum_y = 0;
+    for (int y = y_min; y <= y_max; y++) {
+        int w = half[abs(y - center.y)];
+        int x_min = max(center.x - w, 0);
+        int x_max = min(center.x + w, src.cols - 1);
+
+        const uchar* row = src.ptr<uchar>(y);
+        int64_t row_sum = 0, row_x = 0;
+        for (int x = x_min; x <= x_max; x++) {
+            int value = pixel_value<V>(row, x);
+            row_sum += value;
+            row_x += static_cast<int64_t>(x) * value;
+        }
+        sum += row_sum;
+        sum_x += row_x;
+        sum_y += static_cast<int64_t>(y) * row_sum;
+    }
+    // 圆内全黑时保持原位置
+    if (sum <= 0) return cv::Point2f(center);
+    return cv::Point2f(static_cast<float>(static_cast<double>(sum_x) / sum),
+                       static_cast<float>(static_cast<double>(sum_y) / sum));
+}
+
+// 在所有圆的外接区域上逐行建立 I 与 x*I 的前缀和，y*I 由行号与行和相乘得到
+// 区域内每个像素只访问一次，圆越多、彼此重叠越多越划算
+template <int V>
+static void barycenter_integral(const cv::Mat& src, const vector<cv::Point>& centers, int radius,
+                                vector<cv::Point2f>& barycenters) {
+    cv::Rect region;
+    for (size_t i = 0; i < centers.size(); i++) {
+        cv::Rect rect(centers[i].x - radius, centers[i].y - radius, 2 * radius + 1, 2 * radius + 1);
+        region = (i == 0) ? rect : (region | rect);
+    }
+    region &= cv::Rect(0, 0, src.cols, src.rows);
+
+    const int stride = region.width + 1;
+    vector<int64_t> prefix_sum(static_cast<size_t>(region.height) * stride, 0);
+    vector<int64_t> prefix_x(static_cast<size_t>(region.height) * stride, 0);
+    for (int r = 0; r < region.height; r++) {
+        const uchar* row = src.ptr<uchar>(region.y + r);
+        int64_t* ps = prefix_sum.data() + static_cast<size_t>(r) * stride;
+        int64_t* px = prefix_x.data() + static_cast<size_t>(r) * stride;
+        for (int c = 0; c < region.width; c++) {
+            int x = region.x + c;
+            int value = pixel_value<V>(row, x);
+            ps[c + 1] = ps[c] + value;
+            px[c + 1] = px[c] + static_cast<int64_t>(x) * value;
+        }
+    }
+
+    const vector<int>& half = circle_half_width(radius);
+    barycenters.resize(centers.size());
+    for (size_t i = 0; i < centers.size(); i++) {
+        const cv::Point& center = centers[i];
+        int y_min = max(center.y - radius, region.y);
+        int y_max = min(center.y + radius, region.y + region.height - 1);
+
+        int64_t sum = 0, sum_x = 0, sum_y = 0;
+        for (int y = y_min; y <= y_max; y++) {
+            int w = half[abs(y - center.y)];
+            int c_min = max(center.x - w, region.x) - region.x;
+            int c_max = min(center.x + w, region.x + region.width - 1) - region.x;
+            if (c_min > c_max) continue;
+
+            size_t offset = static_cast<size_t>(y - region.y) * stride;
+            int64_t row_sum = prefix_sum[offset + c_max + 1] - prefix_sum[offset + c_min];
+            sum += row_sum;
+            sum_x += prefix_x[offset + c_max + 1] - prefix_x[offset + c_min];
+            sum_y += static_cast<int64_t>(y) * row_sum;
+        }
+        if (sum <= 0) {
+            barycenters[i] = cv::Point2f(center);
+        } else {
+            barycenters[i] = cv::Point2f(static_cast<float>(static_cast<double>(sum_x) / sum),
+                                         static_cast<float>(static_cast<double>(sum_y) / sum));
+        }
+    }
+}
+
+template <int V>
+static void barycenters_of(const cv::Mat& src, const vector<cv::Point>& centers, int radius,
+                           vector<cv::Point2f>& barycenters, BarycenterMethod method) {
+    if (method == BARYCENTER_METHOD_INTEGRAL) {
+        barycenter_integral<V>(src, centers, radius, barycenters);
+        return;
+    }
+    barycenters.resize(centers.size());
+    for (size_t i = 0; i < centers.size(); i++) {
+        barycenters[i] = (method == BARYCENTER_METHOD_REFERENCE) ?
+                         barycenter_reference<V>(src, centers[i], radius) :
+                         barycenter_mask<V>(src, centers[i], radius);
+    }
+}
+
+bool rm::getBarycenters(const cv::Mat& src, const std::vector<cv::Point>& centers, int radius,
+                        std::vector<cv::Point2f>& barycenters, ArmorColor color, BarycenterMethod method) {
+    barycenters.clear();
+    if (centers.empty()) return true;
+    if (radius < 0) radius = 0;
+
+    if (src.type() == CV_8UC1) {
+        barycenters_of<BARYCENTER_VALUE_GRAY>(src, centers, radius, barycenters, method);
+        return true;
+    }
+    if (src.type() != CV_8UC3) {
+        rm::message("Pointer barycenter error at input type", rm::MSG_ERROR);
+        return false;
+    }
+    switch (color) {
+        case ARMOR_COLOR_BLUE:
+            barycenters_of<BARYCENTER_VALUE_B>(src, centers, radius, barycenters, method);
+            return true;
+        case ARMOR_COLOR_RED:
+            barycenters_of<BARYCENTER_VALUE_R>(src, centers, radius, barycenters, method);
+            return true;
+        case ARMOR_COLOR_PURPLE:
+            barycenters_of<BARYCENTER_VALUE_B_ADD_R>(src, centers, radius, barycenters, method);
+            return true;
+        default:
+            return false;
+    }
+}
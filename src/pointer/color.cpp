@@ -8,74 +8,78 @@ using namespace rm;
 using namespace std;
 
 
-ArmorColor rm::getArmorColorFromHSV(const cv::Mat& src, const rm::LightbarPair &rect_pair) {
-    cv::Mat hsv_M;
-    cvtColor(src, hsv_M, cv::COLOR_BGR2HSV);
-
-    cv::Rect rect_region_1 = rect_pair.first.rect.boundingRect();
-    cv::Rect rect_region_2 = rect_pair.second.rect.boundingRect();
-
-    rect_region_1.x -= fmax(3, rect_region_1.width * 0.5);
-    rect_region_1.y -= fmax(3, rect_region_1.height * 0.25);
-    rect_region_1.width += 2 * fmax(3, rect_region_1.width * 0.5);
-    rect_region_1.height += 2 * fmax(3, rect_region_1.height * 0.25);
-
-    rect_region_2.x -= fmax(3, rect_region_2.width * 0.5);
-    rect_region_2.y -= fmax(3, rect_region_2.height * 0.25);
-    rect_region_2.width += 2 * fmax(3, rect_region_2.width * 0.5);
-    rect_region_2.height += 2 * fmax(3, rect_region_2.height * 0.25);
-
-    rect_region_1 &= cv::Rect(0, 0, src.cols, src.rows);
-    rect_region_2 &= cv::Rect(0, 0, src.cols, src.rows);
-
-    cv::Mat roi_1 = hsv_M(rect_region_1);
-    cv::Mat roi_2 = hsv_M(rect_region_2);
-    
-    double h = 0, s = 0, v = 0, j = 0;
-    int R = 0, G = 0, B = 0, P = 0;
-    for (int row = 0; row < roi_1.rows; row++) {
-        for (int col = 0; col < roi_1.cols; col++) {
-            h = roi_1.at<cv::Vec3b>(row, col)[0];
-            s = roi_1.at<cv::Vec3b>(row, col)[1];
-            v = roi_1.at<cv::Vec3b>(row, col)[2];
-            if(s < 43 || v < 46 || v > 240){
-                continue;
-            }
-            if(h <= 155 && h >= 125){
-                P++;
-            }
-            else if((h <= 180 && h >= 156) || (h <= 10 && h >= 0)){
-                R++;
-            }
-            else if(h <= 124 && h >= 100){
-                B++;
-            }
-            else{
-                continue;
-            }
+// 色相分类，区间与原逐像素判断一致
+enum HueClass {
+    HUE_CLASS_OTHER,
+    HUE_CLASS_PURPLE,               // 125 ~ 155
+    HUE_CLASS_RED,                  // 156 ~ 180, 0 ~ 10
+    HUE_CLASS_BLUE                  // 100 ~ 124
+};
+
+struct HueTable {
+    uchar hue_class[256];
+    HueTable() {
+        for (int h = 0; h < 256; h++) {
+            if (h <= 155 && h >= 125) hue_class[h] = HUE_CLASS_PURPLE;
+            else if ((h <= 180 && h >= 156) || h <= 10) hue_class[h] = HUE_CLASS_RED;
+            else if (h <= 124 && h >= 100) hue_class[h] = HUE_CLASS_BLUE;
+            else hue_class[h] = HUE_CLASS_OTHER;
         }
     }
-    for (int row = 0; row < roi_2.rows; row++) {
-        for (int col = 0; col < roi_2.cols; col++) {
-            h = roi_2.at<cv::Vec3b>(row, col)[0];
-            s = roi_2.at<cv::Vec3b>(row, col)[1];
-            v = roi_2.at<cv::Vec3b>(row, col)[2];
-            if(s < 43 || v < 46 || v > 240) {
-                continue;
-            }
-            if(h <= 155 && h >= 125) {
-                P++;
-            } else if ((h <= 180 && h >= 156) || (h <= 10 && h >= 0)) {
-                R++;
-            } else if (h <= 124 && h >= 100) {
-                B++;
-            } else {
-                continue;
-            }
+};
+
+// 区域内各色相类别的像素计数
+struct ColorVote {
+    int valid[4] = {0, 0, 0, 0};    // 饱和度与亮度合法的像素
+    int all[4] = {0, 0, 0, 0};      // 全部像素
+    int invalid = 0;                // 饱和度或亮度不合法的像素
+};
+
+// 只对区域本身做 BGR2HSV，再查表分类计数，arena 为空时使用线程内复用的缓冲区
+static void vote_color_hsv(const cv::Mat& src, const cv::Rect& rect, ColorVote& vote, FrameArena* arena) {
+    static const HueTable table;
+    thread_local cv::Mat hsv_buffer;
+
+    cv::Rect region = rect & cv::Rect(0, 0, src.cols, src.rows);
+    if (region.width <= 0 || region.height <= 0) return;
+    cv::Mat arena_hsv;
+    if (arena != nullptr) arena_hsv = arena->mat(region.size(), CV_8UC3);
+    cv::Mat& hsv = (arena != nullptr) ? arena_hsv : hsv_buffer;
+    cv::cvtColor(src(region), hsv, cv::COLOR_BGR2HSV);
+
+    for (int row = 0; row < hsv.rows; row++) {
+        const uchar* ptr = hsv.ptr<uchar>(row);
+        for (int col = 0; col < hsv.cols; col++, ptr += 3) {
+            int hue_class = table.hue_class[ptr[0]];
+            int s = ptr[1], v = ptr[2];
+            bool invalid = (s < 43) | (v < 46) | (v > 240);
+            vote.all[hue_class]++;
+            vote.valid[hue_class] += !invalid;
+            vote.invalid += invalid;
         }
     }
+}
 
-    if(2 * P > R && 2 * P > B){
+// 向外扩展区域，灯条两侧的光晕也参与判断
+static cv::Rect extend_color_region(const cv::Rect& rect) {
+    cv::Rect region = rect;
+    region.x -= fmax(3, region.width * 0.5);
+    region.y -= fmax(3, region.height * 0.25);
+    region.width += 2 * fmax(3, region.width * 0.5);
+    region.height += 2 * fmax(3, region.height * 0.25);
+    return region;
+}
+
+// 以全部像素计票，饱和度或亮度不合法的像素同时计为无色
+static ArmorColor decide_color_region(const ColorVote& vote) {
+    int P = vote.all[HUE_CLASS_PURPLE];
+    int R = vote.all[HUE_CLASS_RED];
+    int B = vote.all[HUE_CLASS_BLUE];
+    int None = vote.invalid;
+
+    if((R + B + P) <= None){
+        return ARMOR_COLOR_NONE;
+    } else if(1.5 * P > R && 1.5 * P > B){
         return ARMOR_COLOR_PURPLE;
     } else if (R >= B + P && R != 0){
         return ARMOR_COLOR_RED;
@@ -84,54 +88,15 @@ ArmorColor rm::getArmorColorFromHSV(const cv::Mat& src, const rm::LightbarPair &
     } else {
         return ARMOR_COLOR_NONE;
     }
-    
 }
 
-ArmorColor rm::getArmorColorFromHSV(const cv::Mat& src, const rm::YoloRect& rect) {
-    cv::Mat hsv_M;
-    cvtColor(src, hsv_M, cv::COLOR_BGR2HSV);
-
-    cv::Rect rect_region_1 = rect.box;
-    
-    rect_region_1.x -= fmax(3, rect_region_1.width * 0.5);
-    rect_region_1.y -= fmax(3, rect_region_1.height * 0.25);
-    rect_region_1.width += 2 * fmax(3, rect_region_1.width * 0.5);
-    rect_region_1.height += 2 * fmax(3, rect_region_1.height * 0.25);
-
-    rect_region_1 &= cv::Rect(0, 0, src.cols, src.rows);
-    
-    cv::Mat roi_1 = hsv_M(rect_region_1);
-    
-    double h = 0, s = 0, v = 0, j = 0;
-    int R = 0, G = 0, B = 0, P = 0, None = 0;
-    for (int row = 0; row < roi_1.rows; row++) {
-        for (int col = 0; col < roi_1.cols; col++) {
-            h = roi_1.at<cv::Vec3b>(row, col)[0];
-            s = roi_1.at<cv::Vec3b>(row, col)[1];
-            v = roi_1.at<cv::Vec3b>(row, col)[2];
-            if(s < 43 || v < 46 || v > 240){
-                None++;
-            }
-            if(h <= 155 && h >= 125){
-                P++;
-            }
-            else if((h <= 180 && h >= 156) || (h <= 10 && h >= 0)){
-                R++;
-            }
-            else if(h <= 124 && h >= 100){
-                B++;
-            }
-            else{
-                continue;
-            }
-        }
-    }
-    
-    // std::cout<<R<<" "<<B<<" "<<P<<" "<<None<<std::endl;
+// 两个灯条区域的有效像素计票
+static ArmorColor decide_color_pair(const ColorVote& vote) {
+    int P = vote.valid[HUE_CLASS_PURPLE];
+    int R = vote.valid[HUE_CLASS_RED];
+    int B = vote.valid[HUE_CLASS_BLUE];
 
-    if((R + B + P) <= None){
-        return ARMOR_COLOR_NONE;
-    } else if(1.5 * P > R && 1.5 * P > B){
+    if(2 * P > R && 2 * P > B){
         return ARMOR_COLOR_PURPLE;
     } else if (R >= B + P && R != 0){
         return ARMOR_COLOR_RED;
@@ -142,59 +107,75 @@ ArmorColor rm::getArmorColorFromHSV(const cv::Mat& src, const rm::YoloRect& rect
     }
 }
 
+ArmorColor rm::getArmorColorFromHSV(const cv::Mat& src, const rm::LightbarPair &rect_pair) {
+    // 两个区域可能重叠，重叠部分各自计数
+    ColorVote vote;
+    vote_color_hsv(src, extend_color_region(rect_pair.first.rect.boundingRect()), vote, nullptr);
+    vote_color_hsv(src, extend_color_region(rect_pair.second.rect.boundingRect()), vote, nullptr);
+    return decide_color_pair(vote);
+}
+
+ArmorColor rm::getArmorColorFromHSV(const cv::Mat& src, const rm::LightbarPair &rect_pair, FrameArena& arena) {
+    ColorVote vote;
+    vote_color_hsv(src, extend_color_region(rect_pair.first.rect.boundingRect()), vote, &arena);
+    vote_color_hsv(src, extend_color_region(rect_pair.second.rect.boundingRect()), vote, &arena);
+    return decide_color_pair(vote);
+}
+
+ArmorColor rm::getArmorColorFromHSV(const cv::Mat& src, const rm::YoloRect& rect) {
+    return getArmorColorFromHSV(src, rect.box);
+}
+
+ArmorColor rm::getArmorColorFromHSV(const cv::Mat& src, const cv::Rect& rect) {
+    ColorVote vote;
+    vote_color_hsv(src, extend_color_region(rect), vote, nullptr);
+    return decide_color_region(vote);
+}
+
+ArmorColor rm::getArmorColorFromHSV(const cv::Mat& src, const cv::Rect& rect, FrameArena& arena) {
+    ColorVote vote;
+    vote_color_hsv(src, extend_color_region(rect), vote, &arena);
+    return decide_color_region(vote);
+}
+
+ArmorColor rm::getArmorColorFromHSV(const cv::Mat& src, const cv::RotatedRect& rect) {
+    return getArmorColorFromHSV(src, rect.boundingRect());
+}
+
 ArmorColor rm::getArmorColorFromRGB(const cv::Mat& src, const rm::LightbarPair &rect_pair){
-    cv::Mat _M = src.clone();
-    cv::Rect rect_region_1 = rect_pair.first.rect.boundingRect();
-    cv::Rect rect_region_2 = rect_pair.second.rect.boundingRect();
-    rect_region_1 &= cv::Rect(0, 0, src.cols, src.rows);
-    rect_region_2 &= cv::Rect(0, 0, src.cols, src.rows);
-    cv::Mat roi_1 = _M(rect_region_1);
-    cv::Mat roi_2 = _M(rect_region_2);
+    cv::Rect rect_region[2] = {rect_pair.first.rect.boundingRect(), rect_pair.second.rect.boundingRect()};
 
     long long R = 0, G = 0, B = 0;
     long long n = 0;
-    for (int i = 0; i < roi_1.rows; i++){
-        for (int j = 0; j < roi_1.cols; j++){
-            if (roi_1.at<cv::Vec3b>(i, j)[2] > 250 &&
-                roi_1.at<cv::Vec3b>(i, j)[1] > 250 &&
-                roi_1.at<cv::Vec3b>(i, j)[0] > 250) {
-                continue;
-            }
-
-            R += roi_1.at<cv::Vec3b>(i, j)[2];
-            G += roi_1.at<cv::Vec3b>(i, j)[1];
-            B += roi_1.at<cv::Vec3b>(i, j)[0];
-            n++;
-        }
-    }
-    for(int i = 0; i < roi_2.rows; i++){
-        for(int j = 0; j < roi_2.cols; j++){
-            if (roi_2.at<cv::Vec3b>(i, j)[2] > 250 && 
-                roi_1.at<cv::Vec3b>(i, j)[1] > 250 && 
-                roi_1.at<cv::Vec3b>(i, j)[0] > 250) {
-                continue;
+    for (int k = 0; k < 2; k++) {
+        cv::Rect region = rect_region[k] & cv::Rect(0, 0, src.cols, src.rows);
+        for (int i = 0; i < region.height; i++) {
+            const uchar* ptr = src.ptr<uchar>(region.y + i) + region.x * 3;
+            for (int j = 0; j < region.width; j++, ptr += 3) {
+                // 过曝的白色像素不参与计算
+                if (ptr[2] > 250 && ptr[1] > 250 && ptr[0] > 250) {
+                    continue;
+                }
+                R += ptr[2];
+                G += ptr[1];
+                B += ptr[0];
+                n++;
             }
-                
-
-            R += roi_2.at<cv::Vec3b>(i, j)[2];
-            G += roi_2.at<cv::Vec3b>(i, j)[1];
-            B += roi_2.at<cv::Vec3b>(i, j)[0];
-            n++;
         }
     }
+    if (n == 0) return ARMOR_COLOR_NONE;
 
     R = R / n;
     G = G / n;
     B = B / n;
 
     double B_R = B - R;
-    double B_G = B - G;
 
     if(B_R > 90){
         return ARMOR_COLOR_BLUE;
     } else if (B_R < -90){
         return ARMOR_COLOR_RED;
-    } else if (B_R = 0 || (R < 10 && G < 10 && B < 10)){
+    } else if (R < 10 && G < 10 && B < 10){
         return ARMOR_COLOR_NONE;
     } else {
         return ARMOR_COLOR_PURPLE;
@@ -5,29 +5,8 @@
 using namespace rm;
 using namespace std;
 
-static cv::Point2f getBarycenter(const cv::Mat& gray, const cv::Point center, int radius) {
-    // 计算圆形区域的遍历范围
-    
-    int x_min = max(center.x - radius, 0);
-    int x_max = min(center.x + radius, gray.cols - 1);
-    int y_min = max(center.y - radius, 0);
-    int y_max = min(center.y + radius, gray.rows - 1);
-    
-    // 计算圆形区域的灰度和像素坐标
-    int gray_sum = 0;
-    cv::Point2f pixel_sum = cv::Point2f(0, 0);
-    for (int y = y_min; y <= y_max; ++y) {
-        for (int x = x_min; x <= x_max; ++x) {
-            if (cv::norm(cv::Point(x, y) - center) <= radius) {
-                gray_sum += static_cast<int>(gray.at<uchar>(y, x));
-                pixel_sum += cv::Point2f(x, y) * static_cast<int>(gray.at<uchar>(y, x));
-            }
-        }
-    }
-    return pixel_sum / gray_sum;
-}
-
-PointPair rm::findPointPairBarycenter(Lightbar lightbar, const cv::Mat& gray, double extend_dist, double radius_ratio) {
+PointPair rm::findPointPairBarycenter(Lightbar lightbar, const cv::Mat& gray, double extend_dist, double radius_ratio,
+                                      BarycenterMethod method) {
 
     // 找到灯条的中心点
     cv::Point2f center = lightbar.rect.center;
@@ -74,8 +53,12 @@ PointPair rm::findPointPairBarycenter(Lightbar lightbar, const cv::Mat& gray, do
     int radius = (int)(radius_ratio * cv::norm(end_point0 - end_point1));
     
     // 计算两个端点的质心
-    cv::Point2f first_barycenter = getBarycenter(gray, end_point0, radius);
-    cv::Point2f second_barycenter = getBarycenter(gray, end_point1, radius);
+    vector<cv::Point2f> barycenters;
+    if (!getBarycenters(gray, {end_point0, end_point1}, radius, barycenters, ARMOR_COLOR_NONE, method)) {
+        return PointPair();
+    }
+    cv::Point2f first_barycenter = barycenters[0];
+    cv::Point2f second_barycenter = barycenters[1];
 
     // 保证第一个点在上面，第二个点在下面
     if(first_barycenter.y > second_barycenter.y) {
@@ -1,8 +1,11 @@
 #include "pointer/pointer.h"
 #include "uniterm/uniterm.h"    
+#include <opencv2/core/hal/intrin.hpp>
 #include <cmath>
 #include <algorithm>
 #include <cstdlib>
+#include <cstdint>
+#include <mutex>
 
 using namespace rm;
 using namespace std;
@@ -18,53 +21,338 @@ static std::pair<cv::Scalar, cv::Scalar> BLUE_HUE =
 static std::pair<cv::Scalar, cv::Scalar> PURPLE_HUE =
     std::make_pair(cv::Scalar(125, 0, 0), cv::Scalar(155, 255, 255));
 
-void rm::getGrayScaleRGB(const cv::Mat& input, cv::Mat& gray, ArmorColor color) {
-    cv::Mat channels[3];
-    cv::split(input, channels);
+// 单通道灰度核，每种方法对应一种逐像素运算，均为 uint8 饱和运算
+enum GrayKernel {
+    GRAY_KERNEL_B,                  // B
+    GRAY_KERNEL_G,                  // G
+    GRAY_KERNEL_R,                  // R
+    GRAY_KERNEL_B_ADD_R,            // B + R
+    GRAY_KERNEL_B_SUB_R,            // B - R
+    GRAY_KERNEL_R_SUB_B,            // R - B
+    GRAY_KERNEL_B_ADD_R_SUB_G,      // (B + R) - G
+    GRAY_KERNEL_CVT,                // COLOR_BGR2GRAY
+    GRAY_KERNEL_HSV                 // BGR2HSV -> inRange(H) -> HSV2BGR -> BGR2GRAY
+};
+
+template <int K>
+static inline uchar gray_pixel(int b, int g, int r) {
+    switch (K) {
+        case GRAY_KERNEL_B: return static_cast<uchar>(b);
+        case GRAY_KERNEL_G: return static_cast<uchar>(g);
+        case GRAY_KERNEL_R: return static_cast<uchar>(r);
+        case GRAY_KERNEL_B_ADD_R: return cv::saturate_cast<uchar>(b + r);
+        case GRAY_KERNEL_B_SUB_R: return cv::saturate_cast<uchar>(b - r);
+        case GRAY_KERNEL_R_SUB_B: return cv::saturate_cast<uchar>(r - b);
+        case GRAY_KERNEL_B_ADD_R_SUB_G: return cv::saturate_cast<uchar>(cv::saturate_cast<uchar>(b + r) - g);
+        // 与 OpenCV COLOR_BGR2GRAY 8 位实现相同的定点系数
+        default: return static_cast<uchar>((b * 1868 + g * 9617 + r * 4899 + (1 << 13)) >> 14);
+    }
+}
+
+#if CV_SIMD
+template <int K>
+static inline cv::v_uint8 gray_vector(const cv::v_uint8& b, const cv::v_uint8& g, const cv::v_uint8& r) {
+    switch (K) {
+        case GRAY_KERNEL_B: return b;
+        case GRAY_KERNEL_G: return g;
+        case GRAY_KERNEL_R: return r;
+        case GRAY_KERNEL_B_ADD_R: return b + r;
+        case GRAY_KERNEL_B_SUB_R: return b - r;
+        case GRAY_KERNEL_R_SUB_B: return r - b;
+        default: return (b + r) - g;
+    }
+}
+#endif
+
+// 处理一行BGR像素，不产生中间通道图像
+template <int K>
+static void gray_row(const uchar* src, uchar* dst, int cols) {
+    int col = 0;
+#if CV_SIMD
+    if (K != GRAY_KERNEL_CVT) {
+        const int lanes = cv::v_uint8::nlanes;
+        for (; col <= cols - lanes; col += lanes) {
+            cv::v_uint8 b, g, r;
+            cv::v_load_deinterleave(src + col * 3, b, g, r);
+            cv::v_store(dst + col, gray_vector<K>(b, g, r));
+        }
+    }
+#endif
+    for (; col < cols; col++) {
+        const uchar* p = src + col * 3;
+        dst[col] = gray_pixel<K>(p[0], p[1], p[2]);
+    }
+}
+
+// 与 OpenCV COLOR_BGR2HSV 8 位实现相同的定点除法表
+struct HsvTable {
+    int sdiv[256];
+    int hdiv[256];
+    HsvTable() {
+        sdiv[0] = hdiv[0] = 0;
+        for (int i = 1; i < 256; i++) {
+            sdiv[i] = cv::saturate_cast<int>((255 << 12) / (1. * i));
+            hdiv[i] = cv::saturate_cast<int>((180 << 12) / (6. * i));
+        }
+    }
+};
+
+#if CV_SIMD
+// gray_row_hsv 逐像素运算的向量版本，各步的定点与浮点运算与标量版本逐位一致
+// HSV2BGR 的扇区查表改为按扇区号逐一选择，饱和度为 0 时各表项均等于 v，无需单独分支
+static inline cv::v_int32 gray_vector_hsv(const cv::v_int32& b, const cv::v_int32& g, const cv::v_int32& r,
+                                          const HsvTable& table, int hue_low, int hue_high) {
+    const cv::v_int32 zero = cv::vx_setzero_s32();
+    const cv::v_int32 round = cv::vx_setall_s32(1 << 11);
+
+    // BGR2HSV 色相
+    cv::v_int32 v = cv::v_max(b, cv::v_max(g, r));
+    cv::v_int32 diff = v - cv::v_min(b, cv::v_min(g, r));
+    cv::v_int32 vr = (v == r);
+    cv::v_int32 vg = (v == g);
+    cv::v_int32 h = (vr & (g - b)) +
+                    (~vr & ((vg & (b - r + (diff + diff))) + (~vg & (r - g + (diff << 2)))));
+    h = (h * cv::v_lut(table.hdiv, diff) + round) >> 12;
+    h = cv::v_select(h < zero, h + cv::vx_setall_s32(180), h);
+    h = cv::v_min(cv::v_max(h, zero), cv::vx_setall_s32(255));
+    cv::v_int32 in_range = (h >= cv::vx_setall_s32(hue_low)) & (h <= cv::vx_setall_s32(hue_high));
+    cv::v_int32 s = (diff * cv::v_lut(table.sdiv, v) + round) >> 12;
+
+    // HSV2BGR
+    const cv::v_float32 one = cv::vx_setall_f32(1.f);
+    const cv::v_float32 six = cv::vx_setall_f32(6.f);
+    cv::v_float32 fh = cv::v_cvt_f32(h) * cv::vx_setall_f32(6.f / 180.f);
+    cv::v_float32 fs = cv::v_cvt_f32(s) * cv::vx_setall_f32(1.f / 255.f);
+    cv::v_float32 fv = cv::v_cvt_f32(v) * cv::vx_setall_f32(1.f / 255.f);
+    fh = cv::v_select(fh >= six, fh - six, fh);                 // fh < 12，与 fmod(fh, 6) 相同
+    cv::v_int32 sector = cv::v_floor(fh);
+    fh = fh - cv::v_cvt_f32(sector);
+    cv::v_int32 bad = (sector < zero) | (sector >= cv::vx_setall_s32(6));
+    sector = cv::v_select(bad, zero, sector);
+    fh = cv::v_select(cv::v_reinterpret_as_f32(bad), cv::vx_setzero_f32(), fh);
+
+    cv::v_float32 tab0 = fv;
+    cv::v_float32 tab1 = fv * (one - fs);
+    cv::v_float32 tab2 = fv * (one - fs * fh);
+    cv::v_float32 tab3 = fv * (one - fs * (one - fh));
+
+    // sector_data = {{1, 3, 0}, {1, 0, 2}, {3, 0, 1}, {0, 2, 1}, {0, 1, 3}, {2, 1, 0}}
+    cv::v_float32 fb = tab1, fg = tab3, fr = tab0;
+    cv::v_float32 m1 = cv::v_reinterpret_as_f32(sector == cv::vx_setall_s32(1));
+    cv::v_float32 m2 = cv::v_reinterpret_as_f32(sector == cv::vx_setall_s32(2));
+    cv::v_float32 m3 = cv::v_reinterpret_as_f32(sector == cv::vx_setall_s32(3));
+    cv::v_float32 m4 = cv::v_reinterpret_as_f32(sector == cv::vx_setall_s32(4));
+    cv::v_float32 m5 = cv::v_reinterpret_as_f32(sector == cv::vx_setall_s32(5));
+    fg = cv::v_select(m1, tab0, fg); fr = cv::v_select(m1, tab2, fr);
+    fb = cv::v_select(m2, tab3, fb); fg = cv::v_select(m2, tab0, fg); fr = cv::v_select(m2, tab1, fr);
+    fb = cv::v_select(m3, tab0, fb); fg = cv::v_select(m3, tab2, fg); fr = cv::v_select(m3, tab1, fr);
+    fb = cv::v_select(m4, tab0, fb); fg = cv::v_select(m4, tab1, fg); fr = cv::v_select(m4, tab3, fr);
+    fb = cv::v_select(m5, tab2, fb); fg = cv::v_select(m5, tab1, fg);
+
+    // saturate_cast<uchar>(x * 255) 后按 COLOR_BGR2GRAY 的定点系数求灰度
+    const cv::v_float32 scale = cv::vx_setall_f32(255.f);
+    const cv::v_int32 max_value = cv::vx_setall_s32(255);
+    cv::v_int32 ib = cv::v_min(cv::v_max(cv::v_round(fb * scale), zero), max_value);
+    cv::v_int32 ig = cv::v_min(cv::v_max(cv::v_round(fg * scale), zero), max_value);
+    cv::v_int32 ir = cv::v_min(cv::v_max(cv::v_round(fr * scale), zero), max_value);
+    cv::v_int32 gray = (ib * cv::vx_setall_s32(1868) + ig * cv::vx_setall_s32(9617) +
+                        ir * cv::vx_setall_s32(4899) + cv::vx_setall_s32(1 << 13)) >> 14;
+    return gray & in_range;
+}
+
+static inline void expand_s32(const cv::v_uint8& src, cv::v_int32 dst[4]) {
+    cv::v_uint16 lo, hi;
+    cv::v_expand(src, lo, hi);
+    cv::v_uint32 d0, d1, d2, d3;
+    cv::v_expand(lo, d0, d1);
+    cv::v_expand(hi, d2, d3);
+    dst[0] = cv::v_reinterpret_as_s32(d0);
+    dst[1] = cv::v_reinterpret_as_s32(d1);
+    dst[2] = cv::v_reinterpret_as_s32(d2);
+    dst[3] = cv::v_reinterpret_as_s32(d3);
+}
+#endif
+
+// 逐像素复现 BGR2HSV -> inRange(H) -> HSV2BGR -> BGR2GRAY 的结果，色相不在范围内的像素为 0
+static void gray_row_hsv(const uchar* src, uchar* dst, int cols, int hue_low, int hue_high) {
+    static const HsvTable table;
+    static const int sector_data[6][3] = {{1, 3, 0}, {1, 0, 2}, {3, 0, 1}, {0, 2, 1}, {0, 1, 3}, {2, 1, 0}};
+    const float hscale = 6.f / 180.f;
+
+    int col = 0;
+#if CV_SIMD
+    const int lanes = cv::v_uint8::nlanes;
+    for (; col <= cols - lanes; col += lanes) {
+        cv::v_uint8 b8, g8, r8;
+        cv::v_load_deinterleave(src + col * 3, b8, g8, r8);
+        cv::v_int32 b[4], g[4], r[4];
+        expand_s32(b8, b);
+        expand_s32(g8, g);
+        expand_s32(r8, r);
+
+        cv::v_int32 gray[4];
+        for (int i = 0; i < 4; i++) gray[i] = gray_vector_hsv(b[i], g[i], r[i], table, hue_low, hue_high);
+        cv::v_store(dst + col, cv::v_pack_u(cv::v_pack(gray[0], gray[1]), cv::v_pack(gray[2], gray[3])));
+    }
+#endif
+    for (; col < cols; col++) {
+        int b = src[col * 3], g = src[col * 3 + 1], r = src[col * 3 + 2];
+
+        // BGR2HSV 色相，与 OpenCV 定点实现一致
+        int v = std::max(b, std::max(g, r));
+        int vmin = std::min(b, std::min(g, r));
+        int diff = v - vmin;
+        int vr = v == r ? -1 : 0;
+        int vg = v == g ? -1 : 0;
+        int h = (vr & (g - b)) + (~vr & ((vg & (b - r + 2 * diff)) + ((~vg) & (r - g + 4 * diff))));
+        h = (h * table.hdiv[diff] + (1 << 11)) >> 12;
+        h += h < 0 ? 180 : 0;
+        h = cv::saturate_cast<uchar>(h);
+
+        if (h < hue_low || h > hue_high) {
+            dst[col] = 0;
+            continue;
+        }
+        int s = (diff * table.sdiv[v] + (1 << 11)) >> 12;
+
+        // HSV2BGR，与 OpenCV 浮点实现一致
+        float fh = static_cast<float>(h);
+        float fs = s * (1.f / 255.f);
+        float fv = v * (1.f / 255.f);
+        float fb, fg, fr;
+        if (fs == 0) {
+            fb = fg = fr = fv;
+        } else {
+            fh *= hscale;
+            fh = std::fmod(fh, 6.f);
+            int sector = cvFloor(fh);
+            fh -= sector;
+            if (static_cast<unsigned>(sector) >= 6u) {
+                sector = 0;
+                fh = 0.f;
+            }
+            float tab[4];
+            tab[0] = fv;
+            tab[1] = fv * (1.f - fs);
+            tab[2] = fv * (1.f - fs * fh);
+            tab[3] = fv * (1.f - fs * (1.f - fh));
+            fb = tab[sector_data[sector][0]];
+            fg = tab[sector_data[sector][1]];
+            fr = tab[sector_data[sector][2]];
+        }
+        dst[col] = gray_pixel<GRAY_KERNEL_CVT>(
+            cv::saturate_cast<uchar>(fb * 255.f),
+            cv::saturate_cast<uchar>(fg * 255.f),
+            cv::saturate_cast<uchar>(fr * 255.f));
+    }
+}
+
+// 一种灰度方法对应的行处理函数，HSV 方法需附带色相范围
+struct GrayRow {
+    void (*func)(const uchar*, uchar*, int) = nullptr;
+    int hue_low = 0;
+    int hue_high = 255;
+
+    void operator()(const uchar* src, uchar* dst, int cols) const {
+        if (func != nullptr) func(src, dst, cols);
+        else gray_row_hsv(src, dst, cols, hue_low, hue_high);
+    }
+};
+
+static GrayRow gray_row_kernel(GrayKernel kernel) {
+    GrayRow row;
+    switch (kernel) {
+        case GRAY_KERNEL_B: row.func = &gray_row<GRAY_KERNEL_B>; break;
+        case GRAY_KERNEL_G: row.func = &gray_row<GRAY_KERNEL_G>; break;
+        case GRAY_KERNEL_R: row.func = &gray_row<GRAY_KERNEL_R>; break;
+        case GRAY_KERNEL_B_ADD_R: row.func = &gray_row<GRAY_KERNEL_B_ADD_R>; break;
+        case GRAY_KERNEL_B_SUB_R: row.func = &gray_row<GRAY_KERNEL_B_SUB_R>; break;
+        case GRAY_KERNEL_R_SUB_B: row.func = &gray_row<GRAY_KERNEL_R_SUB_B>; break;
+        case GRAY_KERNEL_B_ADD_R_SUB_G: row.func = &gray_row<GRAY_KERNEL_B_ADD_R_SUB_G>; break;
+        default: row.func = &gray_row<GRAY_KERNEL_CVT>; break;
+    }
+    return row;
+}
+
+static GrayRow gray_row_hue(const std::pair<cv::Scalar, cv::Scalar>& hue) {
+    GrayRow row;
+    row.hue_low = static_cast<int>(hue.first[0]);
+    row.hue_high = static_cast<int>(hue.second[0]);
+    return row;
+}
+
+static GrayRow gray_row_rgb(ArmorColor color) {
     switch (color) {
-        case ARMOR_COLOR_BLUE:
-            gray = channels[0];
-            break;
-        case ARMOR_COLOR_RED:
-            gray = channels[2];
-            break;
-        case ARMOR_COLOR_PURPLE:
-            gray = channels[0] + channels[2];
-            break;
-        default:
-            gray = channels[1];
-            break;
+        case ARMOR_COLOR_BLUE: return gray_row_kernel(GRAY_KERNEL_B);
+        case ARMOR_COLOR_RED: return gray_row_kernel(GRAY_KERNEL_R);
+        case ARMOR_COLOR_PURPLE: return gray_row_kernel(GRAY_KERNEL_B_ADD_R);
+        default: return gray_row_kernel(GRAY_KERNEL_G);
     }
 }
 
-void rm::getGrayScaleHSV(const cv::Mat& input, cv::Mat& gray, ArmorColor color) {
-    // 色彩空间转换
-    cv::Mat hsv;
-    cv::cvtColor(input, hsv, cv::COLOR_BGR2HSV);
+static GrayRow gray_row_hsv(ArmorColor color) {
+    switch (color) {
+        case ARMOR_COLOR_BLUE: return gray_row_hue(BLUE_HUE);
+        case ARMOR_COLOR_RED: return gray_row_hue(RED_HUE);
+        case ARMOR_COLOR_PURPLE: return gray_row_hue(PURPLE_HUE);
+        default: return GrayRow();
+    }
+}
 
-    // 根据颜色设置Hue掩码
-    cv::Mat mask;
+static GrayRow gray_row_sub(ArmorColor color) {
     switch (color) {
-        case ARMOR_COLOR_BLUE:
-            cv::inRange(hsv, BLUE_HUE.first, BLUE_HUE.second, mask);
-            break;
-        case ARMOR_COLOR_RED:
-            cv::inRange(hsv, RED_HUE.first, RED_HUE.second, mask);
-            break;
-        case ARMOR_COLOR_PURPLE:
-            cv::inRange(hsv, PURPLE_HUE.first, PURPLE_HUE.second, mask);
-            break;
-        default:
-            cv::inRange(hsv, cv::Scalar(0, 0, 0), cv::Scalar(255, 255, 255), mask);
-            break;
+        case ARMOR_COLOR_BLUE: return gray_row_kernel(GRAY_KERNEL_B_SUB_R);
+        case ARMOR_COLOR_RED: return gray_row_kernel(GRAY_KERNEL_R_SUB_B);
+        case ARMOR_COLOR_PURPLE: return gray_row_kernel(GRAY_KERNEL_B_ADD_R_SUB_G);
+        default: return gray_row_kernel(GRAY_KERNEL_G);
+    }
+}
+
+// 与 getGrayScale 的分派保持一致
+static GrayRow gray_row_method(ArmorColor color, GrayScaleMethod method) {
+    switch (method) {
+        case GRAY_SCALE_METHOD_RGB: return gray_row_rgb(color);
+        case GRAY_SCALE_METHOD_HSV: return gray_row_hsv(color);
+        case GRAY_SCALE_METHOD_SUB: return gray_row_sub(color);
+        case GRAY_SCALE_METHOD_MIX:
+            if (color == ARMOR_COLOR_BLUE || color == ARMOR_COLOR_RED) return gray_row_rgb(color);
+            if (color == ARMOR_COLOR_PURPLE) return gray_row_hsv(color);
+            return gray_row_kernel(GRAY_KERNEL_CVT);
+        default: return gray_row_kernel(GRAY_KERNEL_CVT);
     }
+}
 
-    // 使用掩码处理原图像
-    cv::bitwise_and(hsv, hsv, gray, mask);
+// 按行并行地单次遍历BGR图像，直接写出灰度图
+static void gray_image(const cv::Mat& input, cv::Mat& gray, const GrayRow& row_func) {
+    gray.create(input.size(), CV_8UC1);
+    cv::parallel_for_(cv::Range(0, input.rows), [&](const cv::Range& range) {
+        for (int row = range.start; row < range.end; row++) {
+            row_func(input.ptr<uchar>(row), gray.ptr<uchar>(row), input.cols);
+        }
+    }, input.total() / static_cast<double>(1 << 16));
+}
 
-    // 色彩空间转换
-    cv::cvtColor(gray, gray, cv::COLOR_HSV2BGR);
-    cv::cvtColor(gray, gray, cv::COLOR_BGR2GRAY);
+// 输入已是单通道时直接拷贝，其余要求为 CV_8UC3
+static bool gray_input_check(const cv::Mat& input, cv::Mat& gray) {
+    if (input.type() == CV_8UC1) {
+        input.copyTo(gray);
+        return false;
+    }
+    if (input.type() != CV_8UC3) {
+        rm::message("Pointer gray scale error at input type", rm::MSG_ERROR);
+        return false;
+    }
+    return true;
+}
+
+void rm::getGrayScaleRGB(const cv::Mat& input, cv::Mat& gray, ArmorColor color) {
+    if (!gray_input_check(input, gray)) return;
+    gray_image(input, gray, gray_row_rgb(color));
+}
+
+void rm::getGrayScaleHSV(const cv::Mat& input, cv::Mat& gray, ArmorColor color) {
+    if (!gray_input_check(input, gray)) return;
+    gray_image(input, gray, gray_row_hsv(color));
 }
 
 void rm::getGrayScaleCVT(const cv::Mat& input, cv::Mat& gray) {
@@ -89,23 +377,8 @@ void rm::getGrayScaleMix(const cv::Mat& input, cv::Mat& gray, ArmorColor color)
 }
 
 void rm::getGrayScaleSub(const cv::Mat& input, cv::Mat& gray, ArmorColor color) {
-    cv::Mat channels[3];
-    cv::split(input, channels);
-    switch (color) {
-        case ArmorColor::ARMOR_COLOR_BLUE:
-            gray = channels[0] - channels[2];
-            break;
-        case ArmorColor::ARMOR_COLOR_RED:
-            gray = channels[2] - channels[0];
-            break;
-
-        case ArmorColor::ARMOR_COLOR_PURPLE:
-            gray = channels[0] + channels[2] - channels[1];
-            break;
-        default:
-            gray = channels[1];
-            break;
-    }
+    if (!gray_input_check(input, gray)) return;
+    gray_image(input, gray, gray_row_sub(color));
 }
 
 void rm::getGrayScale(const cv::Mat& input, cv::Mat& gray, ArmorColor color, GrayScaleMethod method) {
@@ -172,6 +445,112 @@ void rm::getBinary(const cv::Mat& input, cv::Mat& binary, double threshold, Bina
     }
 }
 
+// 灰度图的统计量，在生成灰度的同一次遍历中累计
+struct GrayStat {
+    int min_value = 255;
+    int max_value = 0;
+    uint64_t sum = 0;
+};
+
+bool rm::getGrayBinary(const cv::Mat& input, cv::Mat& gray, cv::Mat& binary, double threshold,
+                       ArmorColor color, GrayScaleMethod gray_method, BinaryMethod binary_method) {
+    if (input.empty()) {
+        return false;
+    }
+    if (input.type() != CV_8UC3) {
+        getGrayScale(input, gray, color, gray_method);
+        if (gray.empty()) return false;
+        getBinary(gray, binary, threshold, binary_method);
+        return true;
+    }
+
+    gray.create(input.size(), CV_8UC1);
+    binary.create(input.size(), CV_8UC1);
+    GrayRow row_func = gray_row_method(color, gray_method);
+
+    // 直接阈值在同一行内完成二值化，与 cv::threshold 对 8 位图像的取整一致
+    bool direct = (binary_method != BINARY_METHOD_MAX_MIN_RATIO && binary_method != BINARY_METHOD_AVERAGE_THRESHOLD);
+    int direct_threshold = cvFloor(threshold);
+
+    GrayStat stat;
+    std::mutex stat_mutex;
+    cv::parallel_for_(cv::Range(0, input.rows), [&](const cv::Range& range) {
+        GrayStat local;
+        for (int row = range.start; row < range.end; row++) {
+            uchar* gray_ptr = gray.ptr<uchar>(row);
+            row_func(input.ptr<uchar>(row), gray_ptr, input.cols);
+
+            if (direct) {
+                uchar* binary_ptr = binary.ptr<uchar>(row);
+                for (int col = 0; col < input.cols; col++) {
+                    binary_ptr[col] = (gray_ptr[col] > direct_threshold) ? 255 : 0;
+                }
+                continue;
+            }
+            for (int col = 0; col < input.cols; col++) {
+                int value = gray_ptr[col];
+                local.min_value = std::min(local.min_value, value);
+                local.max_value = std::max(local.max_value, value);
+                local.sum += value;
+            }
+        }
+        std::lock_guard<std::mutex> lock(stat_mutex);
+        stat.min_value = std::min(stat.min_value, local.min_value);
+        stat.max_value = std::max(stat.max_value, local.max_value);
+        stat.sum += local.sum;
+    }, input.total() / static_cast<double>(1 << 16));
+
+    if (direct) {
+        return true;
+    }
+
+    // 阈值依赖整幅灰度图的统计量，需在灰度图上再遍历一次
+    double threshold_value;
+    if (binary_method == BINARY_METHOD_MAX_MIN_RATIO) {
+        threshold_value = (stat.min_value + stat.max_value) * threshold;
+    } else {
+        double mean = static_cast<double>(stat.sum) / static_cast<double>(input.total());
+        threshold_value = clamp((int)mean + static_cast<int>(threshold), 0, 255);
+    }
+    cv::threshold(gray, binary, threshold_value, 255, cv::THRESH_BINARY);
+    return true;
+}
+
+bool rm::getGrayBinaryROI(const cv::Mat& src, const Armor& armor, cv::Mat& gray, cv::Mat& binary, double threshold,
+                          ArmorColor color, GrayScaleMethod gray_method, BinaryMethod binary_method) {
+    cv::Rect rect = armor.rect & cv::Rect(0, 0, src.cols, src.rows);
+    if (rect.width <= 0 || rect.height <= 0) {
+        rm::message("Pointer gray binary error at armor rect", rm::MSG_ERROR);
+        return false;
+    }
+    return getGrayBinary(src(rect), gray, binary, threshold, color, gray_method, binary_method);
+}
+
+cv::Mat rm::getGrayScale(const cv::Mat& input, FrameArena& arena, ArmorColor color, GrayScaleMethod method) {
+    cv::Mat gray = arena.mat(input.size(), CV_8UC1);
+    getGrayScale(input, gray, color, method);
+    return gray;
+}
+
+cv::Mat rm::getBinary(const cv::Mat& input, FrameArena& arena, double threshold, BinaryMethod method) {
+    cv::Mat binary = arena.mat(input.size(), CV_8UC1);
+    getBinary(input, binary, threshold, method);
+    return binary;
+}
+
+bool rm::getGrayBinaryROI(const cv::Mat& src, const Armor& armor, FrameArena& arena,
+                          cv::Mat& gray, cv::Mat& binary, double threshold,
+                          ArmorColor color, GrayScaleMethod gray_method, BinaryMethod binary_method) {
+    cv::Rect rect = armor.rect & cv::Rect(0, 0, src.cols, src.rows);
+    if (rect.width <= 0 || rect.height <= 0) {
+        rm::message("Pointer gray binary error at armor rect", rm::MSG_ERROR);
+        return false;
+    }
+    gray = arena.mat(rect.size(), CV_8UC1);
+    binary = arena.mat(rect.size(), CV_8UC1);
+    return getGrayBinary(src(rect), gray, binary, threshold, color, gray_method, binary_method);
+}
+
 ArmorID rm::getArmorIDfromClass36(ArmorClass armor_class) {
     int armor_id = armor_class % 9;
     armor_id = id_map[armor_id];
@@ -288,11 +667,12 @@ ArmorColor rm::getRegionColor(const cv::Mat &src, const cv::Rect &rect_region) {
 
     cv::Mat roi = src(region);
 
-    int red_cnt = 0, blue_cnt = 0;
+    int64_t red_cnt = 0, blue_cnt = 0;
     for (int row = 0; row < roi.rows; row++) {
-        for (int col = 0; col < roi.cols; col++) {
-            red_cnt += roi.at<cv::Vec3b>(row, col)[2];
-            blue_cnt += roi.at<cv::Vec3b>(row, col)[0];
+        const uchar* ptr = roi.ptr<uchar>(row);
+        for (int col = 0; col < roi.cols; col++, ptr += 3) {
+            red_cnt += ptr[2];
+            blue_cnt += ptr[0];
         }
     }
     return (blue_cnt > red_cnt) ? ARMOR_COLOR_BLUE : ARMOR_COLOR_RED;
@@ -350,7 +730,7 @@ void rm::getLightbarsFromContours(const std::vector<std::vector<cv::Point>> &con
                                  double max_angle
 ) {
     lightbars.clear();
-    for(auto contour: contours) {
+    for(const auto& contour: contours) {
         rm::Lightbar lightbar;
         rm::setLightbar(lightbar, contour);
         if(isLightBarValid(lightbar, min_rect_side, max_rect_side, min_value_area, min_ratio_area, max_angle)) {
@@ -359,6 +739,111 @@ void rm::getLightbarsFromContours(const std::vector<std::vector<cv::Point>> &con
     }    
 }
 
+// arena 为空时中间结果使用线程内复用的缓冲区
+static void lightbars_from_binary(const cv::Mat& binary,
+                                  rm::FrameArena* arena,
+                                  std::vector<rm::Lightbar> &lightbars,
+                                  double min_rect_side,
+                                  double max_rect_side,
+                                  double min_value_area,
+                                  double min_ratio_area,
+                                  double max_angle
+) {
+    lightbars.clear();
+    if (binary.type() != CV_8UC1) {
+        rm::message("Pointer lightbar error at input type", rm::MSG_ERROR);
+        return;
+    }
+
+    thread_local cv::Mat labels_buffer, outside_buffer, mask_buffer, stats, centroids;
+    thread_local std::vector<uchar> external;
+    thread_local std::vector<std::vector<cv::Point>> contours;
+
+    cv::Mat arena_labels, arena_outside, arena_mask;
+    if (arena != nullptr) {
+        arena_labels = arena->mat(binary.size(), CV_32SC1);
+        arena_outside = arena->mat(binary.rows + 2, binary.cols + 2, CV_8UC1);
+    }
+    cv::Mat& labels = (arena != nullptr) ? arena_labels : labels_buffer;
+    cv::Mat& outside = (arena != nullptr) ? arena_outside : outside_buffer;
+    cv::Mat& mask = (arena != nullptr) ? arena_mask : mask_buffer;
+
+    int label_num = cv::connectedComponentsWithStats(binary, labels, stats, centroids, 8, CV_32S);
+    if (label_num <= 1) return;
+
+    // 与 findContours 相同，前景按 8 邻接、背景按 4 邻接，图像外围视为背景
+    // 从外围漫水填充得到最外层背景，与之 4 邻接的连通域才有 RETR_EXTERNAL 意义下的外轮廓
+    outside.create(binary.rows + 2, binary.cols + 2, CV_8UC1);
+    cv::Mat inner = outside(cv::Rect(1, 1, binary.cols, binary.rows));
+    cv::compare(binary, cv::Scalar(0), inner, cv::CMP_NE);
+    outside.row(0).setTo(cv::Scalar(0));
+    outside.row(outside.rows - 1).setTo(cv::Scalar(0));
+    outside.col(0).setTo(cv::Scalar(0));
+    outside.col(outside.cols - 1).setTo(cv::Scalar(0));
+    cv::floodFill(outside, cv::Point(0, 0), cv::Scalar(128), nullptr, cv::Scalar(), cv::Scalar(), 4);
+
+    external.assign(label_num, 0);
+    for (int y = 0; y < labels.rows; y++) {
+        const int* label_ptr = labels.ptr<int>(y);
+        const uchar* up = outside.ptr<uchar>(y) + 1;
+        const uchar* mid = outside.ptr<uchar>(y + 1) + 1;
+        const uchar* down = outside.ptr<uchar>(y + 2) + 1;
+        for (int x = 0; x < labels.cols; x++) {
+            int label = label_ptr[x];
+            if (label == 0 || external[label]) continue;
+            if (up[x] == 128 || down[x] == 128 || mid[x - 1] == 128 || mid[x + 1] == 128) external[label] = 1;
+        }
+    }
+
+    for (int label = 1; label < label_num; label++) {
+        if (!external[label]) continue;
+
+        // 轮廓经过边界像素中心，最小外接矩形不会大于 (w - 1) * (h - 1)，面积不足时必然不合法
+        // 填充率、长宽比与角度无法由连通域统计量给出只会放宽的界，统一交给轮廓精确判定
+        const int* stat = stats.ptr<int>(label);
+        int box_width = stat[cv::CC_STAT_WIDTH];
+        int box_height = stat[cv::CC_STAT_HEIGHT];
+        if ((box_width - 1) * (box_height - 1) < min_value_area) continue;
+
+        cv::Rect box(stat[cv::CC_STAT_LEFT], stat[cv::CC_STAT_TOP], box_width, box_height);
+        if (arena != nullptr) mask = arena->mat(box.size(), CV_8UC1);
+        cv::compare(labels(box), cv::Scalar(label), mask, cv::CMP_EQ);
+        cv::findContours(mask, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_NONE, box.tl());
+        if (contours.empty()) continue;
+
+        rm::Lightbar lightbar;
+        rm::setLightbar(lightbar, contours[0]);
+        if (isLightBarValid(lightbar, min_rect_side, max_rect_side, min_value_area, min_ratio_area, max_angle)) {
+            lightbars.push_back(lightbar);
+        }
+    }
+}
+
+void rm::getLightbarsFromBinary(const cv::Mat& binary,
+                                std::vector<Lightbar> &lightbars,
+                                double min_rect_side,
+                                double max_rect_side,
+                                double min_value_area,
+                                double min_ratio_area,
+                                double max_angle
+) {
+    lightbars_from_binary(binary, nullptr, lightbars,
+                          min_rect_side, max_rect_side, min_value_area, min_ratio_area, max_angle);
+}
+
+void rm::getLightbarsFromBinary(const cv::Mat& binary,
+                                FrameArena& arena,
+                                std::vector<Lightbar> &lightbars,
+                                double min_rect_side,
+                                double max_rect_side,
+                                double min_value_area,
+                                double min_ratio_area,
+                                double max_angle
+) {
+    lightbars_from_binary(binary, &arena, lightbars,
+                          min_rect_side, max_rect_side, min_value_area, min_ratio_area, max_angle);
+}
+
 // 两个灯条长度的平均值
 double rm::getValueLengthLightbarPair(const Lightbar &lb1, const Lightbar &lb2) {
     return (lb1.length + lb2.length) / 2;
@@ -462,38 +947,6 @@ LightbarPair rm::getBestMatchedLightbarPair(const std::vector<LightbarPair>& pai
     return best_pair;
 }
 
-// 将灯条匹配成对，并筛选最佳配对
-bool rm::getBestMatchedLightbarPair(const std::vector<rm::Lightbar>& lightbars,
-                                    const Armor& armor,
-                                    LightbarPair& best_pair,
-                                    double max_ratio_length, 
-                                    double max_ratio_area,
-                                    double min_ratio_side,
-                                    double max_ratio_side,
-                                    double max_angle_diff,
-                                    double max_angle_avg,
-                                    double max_offset
-){
-    std::vector<rm::LightbarPair> lightbar_pair_list;
-    for(size_t i = 0; i < lightbars.size(); i++) {
-        for(size_t j = i + 1; j < lightbars.size(); j++) {
-            if(isLightBarMatched(lightbars[i], lightbars[j], max_ratio_length, max_ratio_area, min_ratio_side, max_ratio_side, max_angle_diff, max_angle_avg, max_offset)) {
-                lightbar_pair_list.push_back(rm::LightbarPair(lightbars[i], lightbars[j]));
-            }
-        }
-    }
-    if(lightbar_pair_list.size() <= 0) {
-        best_pair = rm::LightbarPair();
-        return false;
-    } else if(lightbar_pair_list.size() == 1) {
-        best_pair = lightbar_pair_list[0];
-        return true;
-    } else {
-        best_pair = getBestMatchedLightbarPair(lightbar_pair_list, armor);
-        return true;
-    }
-}
-
 void rm::getClampRect(const cv::Mat& src, cv::Rect& rect) {
     
     int left = std::clamp((int)(rect.x - rect.width / 2), 0, src.cols - 1);
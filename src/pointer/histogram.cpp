@@ -1,56 +1,298 @@
 #include "pointer/pointer.h"
+#include "pointer/histogram.h"
 #include "uniterm/uniterm.h"    
 #include <cmath>
 #include <algorithm>
 #include <cstdlib>
+#include <cstring>
+#include <cfloat>
+#include <vector>
 
 using namespace rm;
 using namespace std;
 
 
-void rm::getHistogram(const cv::Mat& src, cv::Mat& histogram, int color){
-    cv::Mat Gray_image, my_src = src.clone();
-    std::vector<cv::Mat> channels;
-
-    //设置直方图参数
-    cv::Mat R_hist, G_hist , B_hist, Gray_hist;
-    int histSize = 256;
-    float range[] = {0, 256};
-    const float* histRange = {range};
-    bool uniform = true;
-    bool accumulate = false;
-
-    if(color == 0){
-        cv::cvtColor(my_src, Gray_image, cv::COLOR_BGR2GRAY);
-        //计算直方图
-        cv::calcHist(&Gray_image, 1, 0, cv::Mat(), Gray_hist, 1, &histSize, &histRange, uniform, accumulate);
+// 与 OpenCV COLOR_BGR2GRAY 8 位实现相同的定点系数
+static inline int bgr_to_gray(const uchar* p) {
+    return (p[0] * 1868 + p[1] * 9617 + p[2] * 4899 + (1 << 13)) >> 14;
+}
+
+// a 减去与 b 的交集后剩余的至多四个矩形
+static void subtract_rect(const cv::Rect& a, const cv::Rect& b, vector<cv::Rect>& rects) {
+    cv::Rect inter = a & b;
+    cv::Rect parts[4] = {
+        cv::Rect(a.x, a.y, a.width, inter.y - a.y),
+        cv::Rect(a.x, inter.y + inter.height, a.width, a.y + a.height - inter.y - inter.height),
+        cv::Rect(a.x, inter.y, inter.x - a.x, inter.height),
+        cv::Rect(inter.x + inter.width, inter.y, a.x + a.width - inter.x - inter.width, inter.height)
+    };
+    for (const auto& part : parts) {
+        if (part.width > 0 && part.height > 0) rects.push_back(part);
     }
-    else{
-        cv::split(my_src, channels);
-        //计算直方图
-        cv::calcHist(&channels[0], 1, 0, cv::Mat(), B_hist, 1, &histSize, &histRange, uniform, accumulate);
-        cv::calcHist(&channels[1], 1, 0, cv::Mat(), G_hist, 1, &histSize, &histRange, uniform, accumulate);
-        cv::calcHist(&channels[2], 1, 0, cv::Mat(), R_hist, 1, &histSize, &histRange, uniform, accumulate);
+}
+
+// 双峰查找，与原 getHistDoublePeak 的逐步判断一致
+static pair<int, int> double_peak(const float* histogram, int hist_size) {
+    int firstPeak = 0;
+    float maxVal = histogram[0];
+    for (int i = 1; i < hist_size; ++i) {
+        if (histogram[i] > maxVal) {
+            maxVal = histogram[i];
+            firstPeak = i;
+        }
     }
-    
-    switch (color)
-    {
-    case 0: histogram = Gray_hist.clone(); break;
-       
-    case 1: histogram = B_hist.clone(); break;
 
-    case 2: histogram = G_hist.clone(); break;
+    int myend = 0;
+    for (int i = firstPeak; i < hist_size; ++i) {
+        if (histogram[i] <= 3) {
+            myend = (i + 30 > 250) ? 250 : (i + 30);
+            break;
+        }
+    }
 
-    case 3: histogram = R_hist.clone(); break;
-    
-    default: histogram = Gray_hist.clone(); break;
+    // 以到最大峰距离的平方加权，取加权后的最大值为第二个峰
+    int secondPeak = 0;
+    float maxDist = 0;
+    for (int k = 0; k < myend && k < hist_size; k++) {
+        float dist = static_cast<float>(std::pow(k - firstPeak, 2) * histogram[k]);
+        if (dist > maxDist) {
+            maxDist = dist;
+            secondPeak = k;
+        }
+    }
+    if (secondPeak > 255) {
+        secondPeak = 255;
     }
+    return pair<int, int>(firstPeak, secondPeak);
+}
 
-    //归一化
-    cv::normalize(histogram, histogram, 0, 512, cv::NORM_MINMAX, -1, cv::Mat());
-    
-    return;
+void Histogram::reset() {
+    std::fill(bins_, bins_ + 256, 0);
+    total_ = 0;
+    channel_ = -1;
+    roi_ = cv::Rect();
+    frame_id_ = 0;
+    data_ = nullptr;
+    size_ = cv::Size();
+    step_ = 0;
+    type_ = -1;
+}
+
+void Histogram::accumulate(const cv::Mat& src, const cv::Rect& rect, int sign) {
+    if (rect.width <= 0 || rect.height <= 0) return;
+
+    // 四组子直方图交替累加，避免相邻相同灰度值的写后读依赖
+    int local[4][256];
+    std::memset(local, 0, sizeof(local));
 
+    const int cn = src.channels();
+    for (int row = rect.y; row < rect.y + rect.height; row++) {
+        const uchar* ptr = src.ptr<uchar>(row) + rect.x * cn;
+        int col = 0;
+        if (cn == 1) {
+            for (; col <= rect.width - 4; col += 4) {
+                local[0][ptr[col]]++;
+                local[1][ptr[col + 1]]++;
+                local[2][ptr[col + 2]]++;
+                local[3][ptr[col + 3]]++;
+            }
+            for (; col < rect.width; col++) local[0][ptr[col]]++;
+        } else if (channel_ < 0) {
+            for (; col <= rect.width - 4; col += 4) {
+                local[0][bgr_to_gray(ptr + col * 3)]++;
+                local[1][bgr_to_gray(ptr + col * 3 + 3)]++;
+                local[2][bgr_to_gray(ptr + col * 3 + 6)]++;
+                local[3][bgr_to_gray(ptr + col * 3 + 9)]++;
+            }
+            for (; col < rect.width; col++) local[0][bgr_to_gray(ptr + col * 3)]++;
+        } else {
+            const uchar* channel = ptr + channel_;
+            for (; col <= rect.width - 4; col += 4) {
+                local[0][channel[col * 3]]++;
+                local[1][channel[col * 3 + 3]]++;
+                local[2][channel[col * 3 + 6]]++;
+                local[3][channel[col * 3 + 9]]++;
+            }
+            for (; col < rect.width; col++) local[0][channel[col * 3]]++;
+        }
+    }
+
+    for (int i = 0; i < 256; i++) {
+        bins_[i] += sign * (local[0][i] + local[1][i] + local[2][i] + local[3][i]);
+    }
+    total_ += sign * rect.area();
+}
+
+bool Histogram::build(const cv::Mat& src, const cv::Rect& roi, int channel, uint64_t frame_id) {
+    reset();
+    if (src.type() != CV_8UC1 && src.type() != CV_8UC3) {
+        rm::message("Pointer histogram error at input type", rm::MSG_ERROR);
+        return false;
+    }
+    if (src.type() == CV_8UC3 && channel > 2) {
+        rm::message("Pointer histogram error at channel", rm::MSG_ERROR);
+        return false;
+    }
+
+    channel_ = (src.type() == CV_8UC1) ? -1 : channel;
+    roi_ = (roi.area() > 0) ? (roi & cv::Rect(0, 0, src.cols, src.rows)) : cv::Rect(0, 0, src.cols, src.rows);
+    frame_id_ = frame_id;
+    data_ = src.data;
+    size_ = src.size();
+    step_ = src.step[0];
+    type_ = src.type();
+    accumulate(src, roi_, 1);
+    return true;
+}
+
+bool Histogram::slide(const cv::Mat& src, const cv::Rect& roi, uint64_t frame_id) {
+    // 帧号相同且图像布局一致时才认为是同一帧，否则旧的统计结果不可用
+    bool same_frame = frame_id != 0 && frame_id == frame_id_ && data_ != nullptr && data_ == src.data &&
+                      size_ == src.size() && step_ == src.step[0] && type_ == src.type();
+    cv::Rect next = roi & cv::Rect(0, 0, src.cols, src.rows);
+    cv::Rect inter = next & roi_;
+    if (!same_frame || inter.area() <= 0) {
+        return build(src, roi, channel_, frame_id);
+    }
+
+    vector<cv::Rect> rects;
+    subtract_rect(roi_, next, rects);
+    for (const auto& rect : rects) accumulate(src, rect, -1);
+
+    rects.clear();
+    subtract_rect(next, roi_, rects);
+    for (const auto& rect : rects) accumulate(src, rect, 1);
+
+    roi_ = next;
+    return true;
+}
+
+void Histogram::getNormalized(float normalized[256]) const {
+    int min_value = *std::min_element(bins_, bins_ + 256);
+    int max_value = *std::max_element(bins_, bins_ + 256);
+    // 与 cv::normalize 相同，系数以双精度求出后转为单精度再逐项计算
+    double range = max_value - min_value;
+    double scale = 512.0 * ((range > DBL_EPSILON) ? 1.0 / range : 0.0);
+    double shift = -min_value * scale;
+    float scale_f = static_cast<float>(scale);
+    float shift_f = static_cast<float>(shift);
+    for (int i = 0; i < 256; i++) {
+        normalized[i] = static_cast<float>(bins_[i]) * scale_f + shift_f;
+    }
+}
+
+void Histogram::getNormalized(cv::Mat& histogram) const {
+    histogram.create(256, 1, CV_32F);
+    getNormalized(histogram.ptr<float>());
+}
+
+int Histogram::getOtsuThreshold() const {
+    if (total_ <= 0) return 0;
+    double scale = 1.0 / total_;
+    double mu = 0;
+    for (int i = 0; i < 256; i++) mu += i * static_cast<double>(bins_[i]);
+    mu *= scale;
+
+    double mu1 = 0, q1 = 0;
+    double max_sigma = 0, max_value = 0;
+    for (int i = 0; i < 256; i++) {
+        double p_i = bins_[i] * scale;
+        mu1 *= q1;
+        q1 += p_i;
+        double q2 = 1.0 - q1;
+        if (std::min(q1, q2) < FLT_EPSILON || std::max(q1, q2) > 1.0 - FLT_EPSILON) continue;
+
+        mu1 = (mu1 + i * p_i) / q1;
+        double mu2 = (mu - q1 * mu1) / q2;
+        double sigma = q1 * q2 * (mu1 - mu2) * (mu1 - mu2);
+        if (sigma > max_sigma) {
+            max_sigma = sigma;
+            max_value = i;
+        }
+    }
+    return static_cast<int>(max_value);
+}
+
+std::pair<int, int> Histogram::getDoublePeak() const {
+    float normalized[256];
+    getNormalized(normalized);
+    std::pair<int, int> peak = double_peak(normalized, 256);
+    publish({peak.first, peak.second});
+    return peak;
+}
+
+int Histogram::getCutThreshold(int cut_threshold, int bios, int end) const {
+    float normalized[256];
+    getNormalized(normalized);
+
+    int my_Begin = 10;
+    int final_thread = my_Begin;
+    for (int i = std::min(end, 255); i > my_Begin; i--) {
+        if (normalized[i] >= cut_threshold) {
+            final_thread = i;
+            break;
+        }
+    }
+    final_thread = final_thread + bios;
+    if (final_thread >= 255) {
+        final_thread = 254;
+    }
+    publish({final_thread}, cut_threshold);
+    return final_thread;
+}
+
+int Histogram::getPeakThreshold(int bios) const {
+    float normalized[256];
+    getNormalized(normalized);
+    std::pair<int, int> peak = double_peak(normalized, 256);
+
+    int n = 0, avgNum = 0, my_Begin = 10;
+    int final_thread = my_Begin;
+    for (int i = peak.second; i < my_Begin; i++) {
+        if (n >= 10 && avgNum / n <= 6) {
+            final_thread = i - (n / 2);
+            break;
+        }
+        if (normalized[i] <= 10) {
+            n++;
+            avgNum += normalized[i];
+        } else {
+            n = 0;
+        }
+    }
+    final_thread = final_thread + bios;
+    if (final_thread >= 255) {
+        final_thread = 254;
+    }
+    publish({peak.first, peak.second, final_thread});
+    return final_thread;
+}
+
+void Histogram::render(cv::Mat& show_image, const std::vector<int>& vertical, int horizontal) const {
+    cv::Mat histogram;
+    getNormalized(histogram);
+    rm::showHistogram(histogram, show_image, 1000, 512);
+    if (horizontal >= 0) {
+        rm::setLine_Histogram(show_image, show_image, histogram, horizontal, 0);
+    }
+    for (int line : vertical) {
+        rm::setLine_Histogram(show_image, show_image, histogram, line, 1);
+    }
+}
+
+void Histogram::publish(const std::vector<int>& vertical, int horizontal) const {
+    if (!subscriber_) return;
+    cv::Mat show_image;
+    render(show_image, vertical, horizontal);
+    subscriber_(show_image);
+}
+
+void rm::getHistogram(const cv::Mat& src, cv::Mat& histogram, int color){
+    // color 为 1/2/3 时分别对应 B/G/R 通道，其余统计灰度
+    int channel = (color >= 1 && color <= 3 && src.channels() == 3) ? color - 1 : -1;
+    Histogram engine;
+    engine.build(src, cv::Rect(), channel);
+    engine.getNormalized(histogram);
 }
 
 void rm::setLine_Histogram(cv::Mat& input, cv::Mat& output, cv::Mat& histogram, int set_line, int flag){
@@ -105,129 +347,41 @@ void rm::showHistogram(cv::Mat& histogram, cv::Mat& ShowImage, int wid, int len)
 }
 
 std::pair<int, int> rm::getHistDoublePeak(const cv::Mat& histogram){
-    int firstPeak = 0;
-    double maxVal;
-    int histSize = histogram.total();
-    cv::minMaxLoc(histogram, NULL, &maxVal, NULL, NULL);
-    //寻找最大峰
-    for(int i = 0; i < histSize; ++i){
-        if(histogram.at<float>(i) == maxVal){
-            firstPeak = i;
-            break;
-        }
-    }
-    //找第一个峰末尾
-    int firstPeakEnd = firstPeak;
-    for(int i = firstPeak; i < histSize; ++i){
-        if(histogram.at<float>(i) <= (maxVal / 5)){
-            firstPeakEnd = i;
-            break;
-        }
-    }
-
-    int myend = 0;
-    for(int i = firstPeak; i < histSize; ++i){
-        if(histogram.at<float>(i) <= 3){
-            myend = (i + 30 > 250) ? 250 : (i + 30);
-            break;
-        }
-    }
-    
-    cv::Mat RestDists = cv::Mat::zeros(256, 1, CV_32F);
-    //从第一关峰末尾开始 加权
-    for(int k = 0; k < myend && k < histSize; k++){  
-        RestDists.at<float>(k) = std::pow(k - firstPeak, 2) * histogram.at<float>(k);
-    }
-
-    int secondPeak = 0;
-    cv::Point my_p;
-    //求解第二个峰
-    cv::minMaxLoc(RestDists, NULL, &maxVal, NULL, &my_p);
-    secondPeak = my_p.y;
-
-    if(secondPeak > 255){
-        secondPeak = 255;
-    }
-    return std::pair<int ,int>(firstPeak, secondPeak);
+    cv::Mat hist_float;
+    histogram.convertTo(hist_float, CV_32F);
+    hist_float = hist_float.reshape(1, static_cast<int>(hist_float.total()));
+    if (!hist_float.isContinuous()) hist_float = hist_float.clone();
+    return double_peak(hist_float.ptr<float>(), static_cast<int>(hist_float.total()));
 }
 
 void rm::getHistIncludePeak(const cv::Mat& src, cv::Mat& ShowImage){
-    cv::Mat histogram;
-    rm::getHistogram(src, histogram, 0);
-    std::pair<int, int> HistPeakNum = rm::getHistDoublePeak(histogram);
-    rm::showHistogram(histogram, ShowImage, 1000, 512);
-    rm::setLine_Histogram(ShowImage, ShowImage, histogram, HistPeakNum.first, 1);
-    rm::setLine_Histogram(ShowImage, ShowImage, histogram, HistPeakNum.second, 1);
+    Histogram engine;
+    engine.build(src);
+    std::pair<int, int> HistPeakNum = engine.getDoublePeak();
+    engine.render(ShowImage, {HistPeakNum.first, HistPeakNum.second});
 }
 
 int rm::getThresholdFromHist(const cv::Mat& src, int Cut_thresold, int bios){
-    cv::Mat histogram;
-    rm::getHistogram(src, histogram, 0);
-    int n = 0, avgNum = 0, my_End = 80, my_Begin = 10;
-    int final_thread = my_Begin;
-
-    for(int i = my_End; i > my_Begin; i--){
-        if(histogram.at<float>(i) >= Cut_thresold){
-            final_thread = i;
-            break;
-        }
-    }
-    final_thread = final_thread + bios;
-    if(final_thread >= 255){
-        final_thread = 254;
-    }
-    return final_thread;
+    Histogram engine;
+    engine.build(src);
+    return engine.getCutThreshold(Cut_thresold, bios, 80);
 }
 
 int rm::getThresholdFromHist(const cv::Mat& src, cv::Mat& ShowImage, int Cut_thresold, int bios){
-    cv::Mat histogram;
-    rm::getHistogram(src, histogram, 0);
-    rm::showHistogram(histogram, ShowImage, 1000, 512);
-    int n = 0, avgNum = 0, my_End = 130, my_Begin = 10;
-    int final_thread = my_Begin;
-    
-    for(int i = my_End; i > my_Begin; i--){
-        if(histogram.at<float>(i) >= Cut_thresold){
-            final_thread = i;
-            break;
-        }
-    }
-    final_thread = final_thread + bios;
-    if(final_thread >= 255){
-        final_thread = 254;
-    }
-    rm::setLine_Histogram(ShowImage, ShowImage, histogram, Cut_thresold, 0);
-    rm::setLine_Histogram(ShowImage, ShowImage, histogram, final_thread, 1);
+    Histogram engine;
+    engine.build(src);
+    int final_thread = engine.getCutThreshold(Cut_thresold, bios, 130);
+    engine.render(ShowImage, {final_thread}, Cut_thresold);
     rm::message("final_thread: ", final_thread);
     return final_thread;
 }
 
 int rm::getThresholdFromHistPeak(const cv::Mat& src, cv::Mat& ShowImage, int bios){
-    cv::Mat histogram;
-    rm::getHistogram(src, histogram, 0);
-    rm::getHistIncludePeak(src, ShowImage);
-    std::pair<int, int> HistPeakNum = rm::getHistDoublePeak(histogram);
-    int n = 0, avgNum = 0, my_End = 130, my_Begin = 10;
-    int final_thread = my_Begin;
-    
-    for(int i = HistPeakNum.second; i < my_Begin; i++){
-        if(n >= 10 && avgNum / n <= 6){
-            final_thread = i - (n / 2);
-            break;
-        }
-        if(histogram.at<float>(i) <= 10){
-            n++;
-            avgNum += histogram.at<float>(i);
-        }
-        else{
-            n = 0;
-        }
-    }
-    final_thread = final_thread + bios;
-    if(final_thread >= 255){
-        final_thread = 254;
-    }
-    rm::setLine_Histogram(ShowImage, ShowImage, histogram, final_thread, 1);
+    Histogram engine;
+    engine.build(src);
+    std::pair<int, int> HistPeakNum = engine.getDoublePeak();
+    int final_thread = engine.getPeakThreshold(bios);
+    engine.render(ShowImage, {HistPeakNum.first, HistPeakNum.second, final_thread});
     return final_thread;
 }
 
@@ -272,4 +426,9 @@ void rm::getHistogramEqualization(const cv::Mat& src, cv::Mat& dst) {
             }
         }
     }
-}
\ No newline at end of file
+}
+cv::Mat rm::getHistogramEqualization(const cv::Mat& src, FrameArena& arena) {
+    cv::Mat dst = arena.mat(src.size(), src.type());
+    getHistogramEqualization(src, dst);
+    return dst;
+}
@@ -1,6 +1,7 @@
 #include "pointer/pointer.h"
 #include "uniterm/uniterm.h"
 #include <cmath>
+#include <cstdint>
 #include <algorithm>
 #include <iostream>
 using namespace rm;
@@ -200,25 +201,39 @@ bool rm::isPointValidInImage(const cv::Mat& image, const cv::Point2f& point) {
 
 }
 
+// 矩形框内通道差值 (B - R 或 R - B，饱和到 0) 的均值，矩形框为空时为 0
+static double get_channel_diff_mean(const cv::Mat& input, const cv::Rect& rect, int positive, int negative) {
+    if (rect.width <= 0 || rect.height <= 0) return 0.0;
+    int64_t sum = 0;
+    for (int row = rect.y; row < rect.y + rect.height; row++) {
+        const uchar* ptr = input.ptr<uchar>(row) + rect.x * 3;
+        for (int col = 0; col < rect.width; col++, ptr += 3) {
+            int diff = ptr[positive] - ptr[negative];
+            sum += (diff > 0) ? diff : 0;
+        }
+    }
+    return static_cast<double>(sum) / rect.area();
+}
+
 bool rm::isArmorColorEnemy(const cv::Mat& input,  const rm::LightbarPair &lbp, rm::ArmorColor enemy_color, double threshold) {
-    cv::Mat gray;
-    cv::Mat channels[3];
-    cv::split(input, channels);
-    
+    // 只在两个灯条区域内计算通道差值，不对整幅图像拆分通道
+    int positive, negative;
     if(enemy_color == ARMOR_COLOR_BLUE) {
-        gray = channels[0] - channels[2];
+        positive = 0;
+        negative = 2;
     } else if (enemy_color == ARMOR_COLOR_RED) {
-        gray = channels[2] - channels[0];
+        positive = 2;
+        negative = 0;
     } else {
         return false;
     }
     cv::Rect rect_left = lbp.first.rect.boundingRect();
     cv::Rect rect_right = lbp.second.rect.boundingRect();
-    rm::getClampRect(gray, rect_left);
-    rm::getClampRect(gray, rect_right);
-    cv::Scalar mean_left = cv::mean(gray(rect_left));
-    cv::Scalar mean_right = cv::mean(gray(rect_right));
-    int threshold_total = 0.5 * (int)mean_left.val[0] + 0.5 * (int)mean_right.val[0];
+    rm::getClampRect(input, rect_left);
+    rm::getClampRect(input, rect_right);
+    double mean_left = get_channel_diff_mean(input, rect_left, positive, negative);
+    double mean_right = get_channel_diff_mean(input, rect_right, positive, negative);
+    int threshold_total = 0.5 * (int)mean_left + 0.5 * (int)mean_right;
 
     rm::message("split avg", threshold_total);
 
@@ -0,0 +1,154 @@
+#include "pointer/pointer.h"
+#include <cmath>
+#include <numeric>
+#include <algorithm>
+
+using namespace rm;
+using namespace std;
+
+// 灯条匹配所需的特征，按列存放，匹配时不再访问 Lightbar 及其轮廓
+// 各字段的类型与 getter.cpp 中对应函数的中间结果一致，保证判定结果逐位相同
+struct LightbarFeatures {
+    vector<float>  x;               // 旋转矩形中心
+    vector<float>  y;
+    vector<double> length;
+    vector<double> angle;
+    vector<double> area;            // 旋转矩形面积
+    vector<int>    order;           // 按 x 升序排列后的原始下标
+
+    void extract(const vector<Lightbar>& lightbars) {
+        const size_t n = lightbars.size();
+        x.resize(n);
+        y.resize(n);
+        length.resize(n);
+        angle.resize(n);
+        area.resize(n);
+        for (size_t i = 0; i < n; i++) {
+            x[i] = lightbars[i].rect.center.x;
+            y[i] = lightbars[i].rect.center.y;
+            length[i] = lightbars[i].length;
+            angle[i] = lightbars[i].angle;
+            area[i] = lightbars[i].rect.size.area();
+        }
+        order.resize(n);
+        iota(order.begin(), order.end(), 0);
+        sort(order.begin(), order.end(), [this](int a, int b) {
+            return (x[a] < x[b]) || (x[a] == x[b] && a < b);
+        });
+    }
+};
+
+// 与 isLightBarMatched 相同的判定，i 为原始下标较小的灯条
+// 不含三角函数的条件按位与合并、不逐个提前返回，全部通过后才计算中心偏移量
+static inline bool is_pair_matched(const LightbarFeatures& f, int i, int j,
+                                   double max_ratio_length, double max_ratio_area,
+                                   double min_ratio_side, double max_ratio_side,
+                                   double max_angle_diff, double max_angle_avg, double max_offset) {
+    // getRatioAreaLightbarPair
+    double area1 = f.area[i], area2 = f.area[j];
+    double ratio_area = (area1 > area2) ? (area1 / area2) : (area2 / area1);
+
+    // getRatioLengthLightbarPair
+    double ratio_length = (f.length[i] > f.length[j]) ? (f.length[i] / f.length[j]) : (f.length[j] / f.length[i]);
+
+    // getRatioArmorSide
+    float vx = f.x[i] - f.x[j];
+    float vy = f.y[i] - f.y[j];
+    float center_dis = sqrt(static_cast<double>(vx) * vx + static_cast<double>(vy) * vy);
+    float ratio_side = center_dis / f.length[i];
+
+    // getAngleDiffLightbarPair / getAngleAvgLightbarPair
+    double angle_diff = std::abs(f.angle[i] - f.angle[j]);
+    double angle_avg = (f.angle[i] + f.angle[j]) / 2;
+
+    bool valid = !(ratio_area > max_ratio_area) &
+                 !(ratio_length > max_ratio_length) &
+                 !(ratio_side < min_ratio_side) & !(ratio_side > max_ratio_side) &
+                 !(angle_diff > max_angle_diff) &
+                 !(std::abs(angle_avg) > max_angle_avg);
+    if (!valid) return false;
+
+    // getCenterOffsetLightbarPair / getValueLengthLightbarPair
+    double angle = angle_avg * CV_PI / 180.0;
+    double dx = f.x[j] - f.x[i];
+    double dy = f.y[j] - f.y[i];
+    double offset = std::abs(sin(angle) * dx - cos(angle) * dy);
+    double ratio_offset = offset / ((f.length[i] + f.length[j]) / 2);
+    return !(ratio_offset > max_offset);
+}
+
+// 将灯条匹配成对，并筛选最佳配对
+//
+// 按中心 x 排序后，只在 x 方向距离不超过 max_ratio_side * 最长灯条长度 的窗口内枚举
+// 窗口外的灯条对中心距离必然大于 max_ratio_side * 灯条长度，装甲板宽高比判定一定不通过
+// 多对同时满足时取中心离装甲板中心最近的一对，距离相同时按原始下标 (i, j) 取先出现者
+bool rm::getBestMatchedLightbarPair(const std::vector<rm::Lightbar>& lightbars,
+                                    const Armor& armor,
+                                    LightbarPair& best_pair,
+                                    double max_ratio_length,
+                                    double max_ratio_area,
+                                    double min_ratio_side,
+                                    double max_ratio_side,
+                                    double max_angle_diff,
+                                    double max_angle_avg,
+                                    double max_offset
+){
+    thread_local LightbarFeatures f;
+    f.extract(lightbars);
+    const int n = static_cast<int>(lightbars.size());
+
+    double max_length = 0;
+    for (int i = 0; i < n; i++) max_length = max(max_length, f.length[i]);
+    // 留出浮点舍入的余量，窗口只用于跳过必然不通过的灯条对
+    double window = max_ratio_side * max_length * (1.0 + 1e-5) + 1e-3;
+    bool use_window = std::isfinite(window) && window > 0;
+
+    int match_num = 0;
+    int best_i = -1, best_j = -1;
+    double min_dis = 1e10;
+    int first_i = -1, first_j = -1;
+
+    for (int a = 0; a < n; a++) {
+        int k = f.order[a];
+        for (int b = a + 1; b < n; b++) {
+            int m = f.order[b];
+            if (use_window && static_cast<double>(f.x[m]) - f.x[k] > window) break;
+
+            int i = min(k, m), j = max(k, m);
+            if (!is_pair_matched(f, i, j, max_ratio_length, max_ratio_area, min_ratio_side,
+                                 max_ratio_side, max_angle_diff, max_angle_avg, max_offset)) {
+                continue;
+            }
+
+            // getBestMatchedLightbarPair(pairs, armor) 的距离计算
+            cv::Point2f center((f.x[i] + f.x[j]) / 2, (f.y[i] + f.y[j]) / 2);
+            double dis = cv::norm(center - armor.center);
+            bool earlier = (best_i >= 0) && (i < best_i || (i == best_i && j < best_j));
+            if (dis < min_dis || (dis == min_dis && earlier)) {
+                min_dis = dis;
+                best_i = i;
+                best_j = j;
+            }
+            if (match_num == 0 || i < first_i || (i == first_i && j < first_j)) {
+                first_i = i;
+                first_j = j;
+            }
+            match_num++;
+        }
+    }
+
+    if (match_num <= 0) {
+        best_pair = rm::LightbarPair();
+        return false;
+    } else if (match_num == 1) {
+        best_pair = rm::LightbarPair(lightbars[first_i], lightbars[first_j]);
+        return true;
+    } else if (best_i < 0) {
+        // 没有距离小于初值的灯条对时与原实现一样返回空的灯条对
+        best_pair = rm::LightbarPair();
+        return true;
+    } else {
+        best_pair = rm::LightbarPair(lightbars[best_i], lightbars[best_j]);
+        return true;
+    }
+}
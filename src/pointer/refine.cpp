@@ -0,0 +1,144 @@
+#include "pointer/pointer.h"
+#include "structure/threadpool.hpp"
+#include "uniterm/uniterm.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <algorithm>
+#include <condition_variable>
+
+using namespace rm;
+using namespace std;
+
+// 每个线程复用的中间结果，避免每个装甲板重复申请内存
+struct RefineScratch {
+    cv::Mat gray;
+    cv::Mat binary;
+    vector<vector<cv::Point>> contours;
+    vector<Lightbar> lightbars;
+};
+
+// 一次 refineArmors 调用的共享状态，线程池中晚到的任务只会访问这里
+struct RefineBatch {
+    const cv::Mat* src;
+    vector<Armor>* armors;
+    const ArmorRefineParam* param;
+    size_t total;                                           // 装甲板总数
+
+    atomic<size_t> next{0};                                 // 下一个待领取的装甲板下标
+    atomic<int> success{0};
+    size_t done = 0;                                        // 已完成的装甲板数
+    mutex done_mutex;
+    condition_variable done_cond;
+};
+
+static bool refine_armor(const cv::Mat& src, Armor& armor, const ArmorRefineParam& param, RefineScratch& scratch) {
+    armor.four_points.clear();
+
+    // 与 getGrayBinaryROI 相同的裁剪，灯条与顶点坐标都相对于该区域的左上角
+    cv::Rect roi = armor.rect & cv::Rect(0, 0, src.cols, src.rows);
+    if (!getGrayBinaryROI(src, armor, scratch.gray, scratch.binary, param.threshold,
+                          param.color, param.gray_method, param.binary_method)) {
+        return false;
+    }
+
+    if (param.lightbar_method == LIGHTBAR_METHOD_COMPONENT) {
+        getLightbarsFromBinary(scratch.binary, scratch.lightbars,
+                               param.min_rect_side, param.max_rect_side,
+                               param.min_value_area, param.min_ratio_area, param.max_angle);
+    } else {
+        cv::findContours(scratch.binary, scratch.contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_NONE);
+        getLightbarsFromContours(scratch.contours, scratch.lightbars,
+                                 param.min_rect_side, param.max_rect_side,
+                                 param.min_value_area, param.min_ratio_area, param.max_angle);
+    }
+    if (scratch.lightbars.size() < 2) return false;
+
+    // 灯条对按到装甲板中心的距离挑选，参考点需换算到 ROI 坐标下
+    Armor roi_armor = armor;
+    roi_armor.center -= cv::Point2f(roi.tl());
+    LightbarPair best_pair;
+    if (!getBestMatchedLightbarPair(scratch.lightbars, roi_armor, best_pair,
+                                    param.max_ratio_length, param.max_ratio_area,
+                                    param.min_ratio_side, param.max_ratio_side,
+                                    param.max_angle_diff, param.max_angle_avg, param.max_offset)) {
+        return false;
+    }
+
+    PointPair pp0 = findPointPairBarycenter(best_pair.first, scratch.gray, param.extend_dist, param.radius_ratio,
+                                            param.barycenter_method);
+    PointPair pp1 = findPointPairBarycenter(best_pair.second, scratch.gray, param.extend_dist, param.radius_ratio,
+                                            param.barycenter_method);
+    setArmorFourPointsRelative(armor, pp0, pp1);
+    for (auto& point : armor.four_points) point += cv::Point2f(roi.tl());
+
+    if (param.reset_radius > 0) {
+        resetArmorFourPoints(src, armor, param.reset_radius, param.barycenter_method);
+    }
+    return armor.four_points.size() == 4;
+}
+
+// 不断领取下一个装甲板直至全部领完，快的线程自然会多处理几个
+static void refine_loop(const shared_ptr<RefineBatch>& batch) {
+    thread_local RefineScratch scratch;
+
+    const size_t total = batch->total;
+    size_t finished = 0;
+    while (true) {
+        size_t index = batch->next.fetch_add(1, memory_order_relaxed);
+        if (index >= total) break;
+        if (refine_armor(*batch->src, (*batch->armors)[index], *batch->param, scratch)) {
+            batch->success.fetch_add(1, memory_order_relaxed);
+        }
+        finished++;
+    }
+    if (finished == 0) return;
+
+    lock_guard<mutex> lock(batch->done_mutex);
+    batch->done += finished;
+    if (batch->done == total) batch->done_cond.notify_all();
+}
+
+// 常驻线程池，首次调用时按参数创建，之后的调用均复用
+static ThreadPool* refine_pool(size_t thread_num) {
+    static once_flag flag;
+    static unique_ptr<ThreadPool> pool;
+    call_once(flag, [thread_num] {
+        size_t num = thread_num;
+        if (num == 0) num = min(max(thread::hardware_concurrency(), 2u) - 1, 4u);
+        pool.reset(new ThreadPool(num));
+    });
+    return pool.get();
+}
+
+int rm::refineArmors(const cv::Mat& src, std::vector<Armor>& armors, const ArmorRefineParam& param) {
+    if (armors.empty()) return 0;
+    if (src.empty() || src.type() != CV_8UC3) {
+        rm::message("Pointer refine error at input type", rm::MSG_ERROR);
+        return 0;
+    }
+
+    shared_ptr<RefineBatch> batch = make_shared<RefineBatch>();
+    batch->src = &src;
+    batch->armors = &armors;
+    batch->param = &param;
+    batch->total = armors.size();
+
+    // 单个装甲板直接在调用线程处理，不经过线程池
+    if (armors.size() > 1) {
+        ThreadPool* pool = refine_pool(param.thread_num);
+        size_t helper_num = min(pool->size(), armors.size() - 1);
+        for (size_t i = 0; i < helper_num; i++) {
+            pool->post([batch] { refine_loop(batch); });
+        }
+    }
+
+    // 调用线程同样参与处理，结束后只需等待其它线程手中的装甲板
+    refine_loop(batch);
+    {
+        unique_lock<mutex> lock(batch->done_mutex);
+        batch->done_cond.wait(lock, [&] { return batch->done == armors.size(); });
+    }
+    return batch->success.load(memory_order_relaxed);
+}
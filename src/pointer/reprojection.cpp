@@ -1,20 +1,50 @@
 #include "pointer/pointer.h"
 #include "uniterm/uniterm.h"
+#include <cmath>
 #include <vector>
+#include <algorithm>
 
 using namespace rm;
 
-static cv::Mat small_decal;
-static cv::Mat big_decal;
+// 同一尺寸装甲板的贴图缓存，金字塔第 0 层为原图，四点为第 0 层上的坐标
+struct DecalCache {
+    std::vector<cv::Mat>     pyramid;
+    std::vector<cv::Point2f> points;
+};
 
-static std::vector<cv::Point2f> small_decal_points;
-static std::vector<cv::Point2f> big_decal_points;
+static DecalCache small_cache;
+static DecalCache big_cache;
 
 const static int real_armor_sw = 135;
 const static int real_armor_sh = 125;
 
 const static int real_armor_bw = 230;
-const static int real_armor_bh = 127; 
+const static int real_armor_bh = 127;
+
+const static int max_pyramid_level = 4;
+
+// 逐层下采样直至短边过小，纯色区域下采样后颜色不变，绿色键值依然有效
+static void build_pyramid(const cv::Mat& decal, DecalCache& cache) {
+    cache.pyramid.clear();
+    if (decal.empty()) return;
+    cache.pyramid.push_back(decal);
+    while ((int)cache.pyramid.size() <= max_pyramid_level) {
+        const cv::Mat& last = cache.pyramid.back();
+        if (std::min(last.cols, last.rows) < 32) break;
+        cv::Mat next;
+        cv::pyrDown(last, next);
+        cache.pyramid.push_back(next);
+    }
+}
+
+static void set_decal_points(int pixel_armor_w, int pixel_armor_h, int pixel_point_w, int pixel_point_h,
+                             std::vector<cv::Point2f>& points) {
+    points.clear();
+    points.emplace_back(pixel_armor_w/2 - pixel_point_w/2, pixel_armor_h/2 - pixel_point_h/2);
+    points.emplace_back(pixel_armor_w/2 + pixel_point_w/2, pixel_armor_h/2 - pixel_point_h/2);
+    points.emplace_back(pixel_armor_w/2 - pixel_point_w/2, pixel_armor_h/2 + pixel_point_h/2);
+    points.emplace_back(pixel_armor_w/2 + pixel_point_w/2, pixel_armor_h/2 + pixel_point_h/2);
+}
 
 void rm::initReprojection(
     double real_point_sw, double real_point_sh,
@@ -22,7 +52,8 @@ void rm::initReprojection(
     std::string small_path,
     std::string big_path
 ) {
-    small_decal = cv::imread(small_path, cv::IMREAD_COLOR);
+    cv::Mat small_decal = cv::imread(small_path, cv::IMREAD_COLOR);
+    cv::Mat big_decal;
     if(big_path.size() == 0) {
         big_decal = small_decal;
     } else {
@@ -32,6 +63,8 @@ void rm::initReprojection(
         message("Could not open or find the image!\n", rm::MSG_ERROR);
         return;
     }
+    build_pyramid(small_decal, small_cache);
+    build_pyramid(big_decal, big_cache);
     paramReprojection(real_point_sw, real_point_sh, real_point_bw, real_point_bh);
 }
 
@@ -39,12 +72,16 @@ void rm::paramReprojection(
     double real_point_sw, double real_point_sh,
     double real_point_bw, double real_point_bh
 ) {
+    if (small_cache.pyramid.empty() || big_cache.pyramid.empty()) {
+        message("Reprojection decal is not initialized", rm::MSG_ERROR);
+        return;
+    }
 
-    int pixel_armor_sw = small_decal.cols;
-    int pixel_armor_sh = small_decal.rows;
+    int pixel_armor_sw = small_cache.pyramid[0].cols;
+    int pixel_armor_sh = small_cache.pyramid[0].rows;
 
-    int pixel_armor_bw = big_decal.cols;
-    int pixel_armor_bh = big_decal.rows;
+    int pixel_armor_bw = big_cache.pyramid[0].cols;
+    int pixel_armor_bh = big_cache.pyramid[0].rows;
 
     int pixel_point_sw = (real_point_sw / real_armor_sw) * pixel_armor_sw;
     int pixel_point_sh = (real_point_sh / real_armor_sh) * pixel_armor_sh;
@@ -52,39 +89,118 @@ void rm::paramReprojection(
     int pixel_point_bw = (real_point_bw / real_armor_bw) * pixel_armor_bw;
     int pixel_point_bh = (real_point_bh / real_armor_bh) * pixel_armor_bh;
 
-    small_decal_points.clear();
-    small_decal_points.emplace_back(pixel_armor_sw/2 - pixel_point_sw/2, pixel_armor_sh/2 - pixel_point_sh/2);
-    small_decal_points.emplace_back(pixel_armor_sw/2 + pixel_point_sw/2, pixel_armor_sh/2 - pixel_point_sh/2);
-    small_decal_points.emplace_back(pixel_armor_sw/2 - pixel_point_sw/2, pixel_armor_sh/2 + pixel_point_sh/2);
-    small_decal_points.emplace_back(pixel_armor_sw/2 + pixel_point_sw/2, pixel_armor_sh/2 + pixel_point_sh/2);
+    set_decal_points(pixel_armor_sw, pixel_armor_sh, pixel_point_sw, pixel_point_sh, small_cache.points);
+    set_decal_points(pixel_armor_bw, pixel_armor_bh, pixel_point_bw, pixel_point_bh, big_cache.points);
+}
 
-    big_decal_points.clear();
-    big_decal_points.emplace_back(pixel_armor_bw/2 - pixel_point_bw/2, pixel_armor_bh/2 - pixel_point_bh/2);
-    big_decal_points.emplace_back(pixel_armor_bw/2 + pixel_point_bw/2, pixel_armor_bh/2 - pixel_point_bh/2);
-    big_decal_points.emplace_back(pixel_armor_bw/2 - pixel_point_bw/2, pixel_armor_bh/2 + pixel_point_bh/2);
-    big_decal_points.emplace_back(pixel_armor_bw/2 + pixel_point_bw/2, pixel_armor_bh/2 + pixel_point_bh/2);
+// 将贴图投影到 dst 的四点上，贴图中纯绿色 (0, 255, 0) 的像素写入 dst，其余像素保持不变
+//
+// 只在贴图投影后的外接矩形内做 warpPerspective，变换矩阵相应平移到该矩形的原点
+// 装甲板在画面中的宽度不足贴图的一半时改用金字塔中尺寸相近的一层，减少采样混叠
+static void warp_decal(cv::Mat& dst, const DecalCache& cache, const std::vector<cv::Point2f>& four_points,
+                       bool use_pyramid) {
+    if (cache.pyramid.empty() || cache.points.size() != 4 || four_points.size() != 4) return;
+
+    int level = 0;
+    if (use_pyramid) {
+        double target = 0.5 * (cv::norm(four_points[1] - four_points[0]) + cv::norm(four_points[3] - four_points[2]));
+        double source = cv::norm(cache.points[1] - cache.points[0]);
+        while (level + 1 < (int)cache.pyramid.size() && source * 0.5 >= target) {
+            source *= 0.5;
+            level++;
+        }
+    }
+    const cv::Mat& decal = cache.pyramid[level];
+    double scale_x = (double)decal.cols / cache.pyramid[0].cols;
+    double scale_y = (double)decal.rows / cache.pyramid[0].rows;
+
+    std::vector<cv::Point2f> decal_points(4);
+    for (int i = 0; i < 4; i++) {
+        decal_points[i] = cv::Point2f(cache.points[i].x * scale_x, cache.points[i].y * scale_y);
+    }
+    cv::Mat matrix = cv::getPerspectiveTransform(decal_points, four_points);
+
+    // 贴图四角投影后的外接矩形，投影到相机后方时退化为整幅图像
+    cv::Rect image_rect(0, 0, dst.cols, dst.rows);
+    cv::Rect roi = image_rect;
+    const double* m = matrix.ptr<double>();
+    double corners[4][2] = {{0, 0}, {(double)decal.cols, 0}, {0, (double)decal.rows}, {(double)decal.cols, (double)decal.rows}};
+    double min_x = 1e18, min_y = 1e18, max_x = -1e18, max_y = -1e18;
+    bool valid = true;
+    for (int i = 0; i < 4 && valid; i++) {
+        double w = m[6] * corners[i][0] + m[7] * corners[i][1] + m[8];
+        if (w <= 1e-9) {
+            valid = false;
+            break;
+        }
+        double x = (m[0] * corners[i][0] + m[1] * corners[i][1] + m[2]) / w;
+        double y = (m[3] * corners[i][0] + m[4] * corners[i][1] + m[5]) / w;
+        min_x = std::min(min_x, x);
+        min_y = std::min(min_y, y);
+        max_x = std::max(max_x, x);
+        max_y = std::max(max_y, y);
+    }
+    if (valid) {
+        // w 略大于阈值时投影坐标可达 1e12，四个边界都需先在浮点下截断，再转换为整数
+        min_x = std::min(std::max(min_x, -1.0), (double)dst.cols);
+        min_y = std::min(std::max(min_y, -1.0), (double)dst.rows);
+        max_x = std::min(std::max(max_x, -1.0), (double)dst.cols);
+        max_y = std::min(std::max(max_y, -1.0), (double)dst.rows);
+        roi = cv::Rect(cv::Point(cvFloor(min_x) - 1, cvFloor(min_y) - 1),
+                       cv::Point(cvCeil(max_x) + 2, cvCeil(max_y) + 2)) & image_rect;
+    }
+    if (roi.width <= 0 || roi.height <= 0) return;
+
+    cv::Mat shift = (cv::Mat_<double>(3, 3) << 1, 0, -roi.x, 0, 1, -roi.y, 0, 0, 1);
+    matrix = shift * matrix;
+
+    // 以 dst 原有像素为底，BORDER_TRANSPARENT 不覆盖贴图外的像素
+    thread_local cv::Mat warped;
+    dst(roi).copyTo(warped);
+    cv::warpPerspective(decal, warped, matrix, roi.size(), cv::INTER_LINEAR, cv::BORDER_TRANSPARENT);
+
+    for (int row = 0; row < roi.height; row++) {
+        const uchar* warped_ptr = warped.ptr<uchar>(row);
+        uchar* dst_ptr = dst.ptr<uchar>(roi.y + row) + roi.x * 3;
+        for (int col = 0; col < roi.width; col++, warped_ptr += 3, dst_ptr += 3) {
+            if (warped_ptr[0] == 0 && warped_ptr[1] == 255 && warped_ptr[2] == 0) {
+                dst_ptr[0] = 0;
+                dst_ptr[1] = 255;
+                dst_ptr[2] = 0;
+            }
+        }
+    }
+}
 
+static const DecalCache* select_decal(rm::ArmorSize size) {
+    if (size == rm::ARMOR_SIZE_SMALL_ARMOR) return &small_cache;
+    if (size == rm::ARMOR_SIZE_BIG_ARMOR) return &big_cache;
+    return nullptr;
 }
 
-void rm::setReprojection(const cv::Mat& src, cv::Mat& dst, std::vector<cv::Point2f> four_points, rm::ArmorSize size) {
+void rm::setReprojection(const cv::Mat& src, cv::Mat& dst, std::vector<cv::Point2f> four_points, rm::ArmorSize size,
+                         bool use_pyramid) {
     if(four_points.size() != 4) return;
-    cv::Mat copy = src.clone();
-
-    if(size == rm::ARMOR_SIZE_SMALL_ARMOR) {
-        cv::Mat small_trans_matrix = cv::getPerspectiveTransform(small_decal_points, four_points);
-        cv::warpPerspective(small_decal, copy, small_trans_matrix, copy.size(), cv::INTER_LINEAR, cv::BORDER_TRANSPARENT);
-    } else if (size == rm::ARMOR_SIZE_BIG_ARMOR) {
-        cv::Mat big_trans_matrix = cv::getPerspectiveTransform(big_decal_points, four_points);
-        cv::warpPerspective(big_decal, copy, big_trans_matrix, copy.size(), cv::INTER_LINEAR, cv::BORDER_TRANSPARENT);
+    if (src.type() != CV_8UC3) {
+        message("Reprojection error at input type", rm::MSG_ERROR);
+        return;
     }
+    if (dst.data != src.data) src.copyTo(dst);
 
-    cv::Mat mask, mask_inv;
-    cv::inRange(copy, cv::Scalar(0, 255, 0), cv::Scalar(0, 255, 0), mask);
-    cv::bitwise_not(mask, mask_inv);
+    const DecalCache* cache = select_decal(size);
+    if (cache != nullptr) warp_decal(dst, *cache, four_points, use_pyramid);
+}
 
-    cv::Mat background, foreground;
-    cv::bitwise_and(src, src, background, mask_inv);
-    cv::bitwise_and(copy, copy, foreground, mask);
-    
-    cv::add(background, foreground, dst);
+void rm::setReprojection(const cv::Mat& src, cv::Mat& dst, const std::vector<Armor>& armors, bool use_pyramid) {
+    if (src.type() != CV_8UC3) {
+        message("Reprojection error at input type", rm::MSG_ERROR);
+        return;
+    }
+    if (dst.data != src.data) src.copyTo(dst);
+
+    for (const auto& armor : armors) {
+        const DecalCache* cache = select_decal(armor.size);
+        if (cache == nullptr || armor.four_points.size() != 4) continue;
+        warp_decal(dst, *cache, armor.four_points, use_pyramid);
+    }
 }
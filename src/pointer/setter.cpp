@@ -111,46 +111,22 @@ void rm::setArmorFourPoints(Armor& armor, const PointPair& pp0, const PointPair&
     setRelativeToAbsoluteTrans(armor);
 }
 
-void rm::resetArmorFourPoints(const cv::Mat& src, Armor& armor, double radius) {
+void rm::resetArmorFourPoints(const cv::Mat& src, Armor& armor, double radius, BarycenterMethod method) {
     if (armor.four_points.size() != 4) return;
+    if (armor.color == ARMOR_COLOR_NONE) return;
 
     double dist = 0.5 * cv::norm(armor.four_points[0] - armor.four_points[2]) +
                   0.5 * cv::norm(armor.four_points[1] - armor.four_points[3]);
     int r = radius * dist;
 
-    for(int i = 0; i < 4; i++) {
-        
-        cv::Point center = static_cast<cv::Point>(armor.four_points[i]);
-        int x_min = max(center.x - r, 0);
-        int x_max = min(center.x + r, src.cols - 1);
-        int y_min = max(center.y - r, 0);
-        int y_max = min(center.y + r, src.rows - 1);
-
-        int gray_sum = 0;
-        cv::Point2f pixel_sum = cv::Point2f(0, 0);
-        for (int y = y_min; y <= y_max; ++y) {
-            for (int x = x_min; x <= x_max; ++x) {
-                if (cv::norm(cv::Point(x, y) - center) > r) continue;
-                
-                int gray_num = 0;
-                switch(armor.color) {
-                    case ARMOR_COLOR_BLUE:
-                        gray_num = src.at<cv::Vec3b>(y, x)[0];
-                        break;
-                    case ARMOR_COLOR_RED:
-                        gray_num = src.at<cv::Vec3b>(y, x)[2];
-                        break;
-                    case ARMOR_COLOR_PURPLE:
-                        gray_num = src.at<cv::Vec3b>(y, x)[0] + src.at<cv::Vec3b>(y, x)[2];
-                        break;
-                    case ARMOR_COLOR_NONE:
-                        return;
-                }
-                pixel_sum += cv::Point2f(x, y) * gray_num;
-                gray_sum += gray_num;
-            }
-        }
-        armor.four_points[i] = pixel_sum / gray_sum;
+    vector<cv::Point> centers(4);
+    for (int i = 0; i < 4; i++) {
+        centers[i] = static_cast<cv::Point>(armor.four_points[i]);
+    }
+    vector<cv::Point2f> barycenters;
+    if (!getBarycenters(src, centers, r, barycenters, armor.color, method)) return;
+    for (int i = 0; i < 4; i++) {
+        armor.four_points[i] = barycenters[i];
     }
 }
 
@@ -68,6 +68,16 @@ TimePoint transUlltoTime(unsigned long long time) {
     return timePoint;
 }
 
+TimePoint transMonotonicToTime(long long monotonic_ns) {
+    // 同时采样两个时钟，以当前时刻的差值作为两者的偏移
+    long long steady_now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    TimePoint now = getTime();
+
+    return now - std::chrono::duration_cast<TimePoint::duration>(
+        std::chrono::nanoseconds(steady_now - monotonic_ns));
+}
+
 std::string getTimeStr() {
     // 获取当前时间点
     auto now = std::chrono::system_clock::now();
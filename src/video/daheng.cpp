@@ -25,26 +25,32 @@ struct CallbackParam {
 void GX_STDC OnFrameCallbackFun(GX_FRAME_CALLBACK_PARAM* capture_frame) {
     TimePoint time_stamp = getTime();
     CallbackParam* callback_param = reinterpret_cast<CallbackParam*>(capture_frame->pUserParam);
-    float yaw = 0, pitch = 0, roll = 0;
-    if (callback_param->yaw != nullptr && callback_param->pitch != nullptr && callback_param->roll != nullptr) {
-        yaw = *(callback_param->yaw);
-        pitch = *(callback_param->pitch);
-        roll = *(callback_param->roll);
+    Camera *camera = callback_param->camera;
+
+    // 回调在图像传输完成后触发，忽略读出与传输耗时，以回调时刻减去曝光时间近似曝光开始时刻
+    PoseStamp pose{};
+    std::chrono::duration<double, std::micro> exposure(camera->exposure_us);
+    TimePoint exposure_start = time_stamp - std::chrono::duration_cast<TimePoint::duration>(exposure);
+    if (!rm::getExposurePose(camera, exposure_start, pose)) {
+        if (callback_param->yaw != nullptr && callback_param->pitch != nullptr && callback_param->roll != nullptr) {
+            pose.yaw = *(callback_param->yaw);
+            pose.pitch = *(callback_param->pitch);
+            pose.roll = *(callback_param->roll);
+        }
     }
 
-    Camera *camera = callback_param->camera;
     bool flip = callback_param->flip;
     
-    shared_ptr<Frame> frame = make_shared<Frame>();
+    shared_ptr<Frame> frame = camera->frame_pool->acquire();
 
-    frame->image = make_shared<cv::Mat>(camera->height, camera->width, CV_8UC3);
     frame->time_point = time_stamp;
     frame->camera_id = camera->camera_id;
     frame->width = camera->width;
     frame->height = camera->height;
-    frame->yaw = yaw;
-    frame->pitch = pitch;
-    frame->roll = roll;
+    frame->locate = pose.locate;
+    frame->yaw = pose.yaw;
+    frame->pitch = pose.pitch;
+    frame->roll = pose.roll;
     
 
     DX_BAYER_CONVERT_TYPE convert_type = RAW2RGB_NEIGHBOUR;
@@ -67,7 +73,7 @@ void GX_STDC OnFrameCallbackFun(GX_FRAME_CALLBACK_PARAM* capture_frame) {
         return;
     }
 
-    camera->buffer->push(frame);
+    rm::pushCameraFrame(camera, frame);
 }
 
 bool rm::getDaHengCameraNum(int& num) {
@@ -114,6 +120,7 @@ bool rm::setDaHengArgs(
     status = GXSetEnum(device, GX_ENUM_EXPOSURE_AUTO, GX_EXPOSURE_AUTO_OFF);
     status = GXSetEnum(device, GX_ENUM_EXPOSURE_MODE, GX_EXPOSURE_MODE_TIMED);
     status = GXSetFloat(device, GX_FLOAT_EXPOSURE_TIME, exposure);
+    camera->exposure_us = exposure;
     
     // 增益
     status = GXSetEnum(device, GX_ENUM_GAIN_AUTO, GX_GAIN_AUTO_OFF);
@@ -158,6 +165,7 @@ bool rm::openDaHeng(
     }
     camera->buffer = new SwapBuffer<Frame>();
     camera->camera_id = device_num;
+    rm::openCameraEvent(camera);
     
 
     // 打开设备
@@ -201,6 +209,12 @@ bool rm::openDaHeng(
     camera->width = static_cast<int>(image_width);
     camera->height = static_cast<int>(image_height);
 
+    // 按图像尺寸预分配帧池
+    if (camera->frame_pool != nullptr) {
+        delete camera->frame_pool;
+    }
+    camera->frame_pool = new FramePool(camera->width, camera->height, CV_8UC3);
+
     // 设置相机参数
     rm::setDaHengArgs(camera, exposure, gain, fps);
 
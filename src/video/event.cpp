@@ -0,0 +1,108 @@
+#include "video/video.h"
+#include "video/recorder.h"
+#include "uniterm/uniterm.h"
+#include <sys/eventfd.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <errno.h>
+#include <cstdint>
+#include <thread>
+
+// 为相机创建新帧通知，每次推帧后 eventfd 计数加一
+bool rm::openCameraEvent(Camera *camera) {
+    if (camera == nullptr) {
+        rm::message("Video event error at nullptr camera", rm::MSG_ERROR);
+        return false;
+    }
+    if (camera->event_fd >= 0) {
+        return true;
+    }
+
+    camera->event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (camera->event_fd < 0) {
+        rm::message("Video event error creating eventfd", rm::MSG_ERROR);
+        return false;
+    }
+    return true;
+}
+
+// 推入帧缓冲区并唤醒等待该相机的消费者
+void rm::pushCameraFrame(Camera *camera, std::shared_ptr<Frame> frame) {
+    // 先登记再读取录制器指针，与 setCameraRecorder 中先替换指针再等待登记归零配对（均为顺序一致）
+    camera->recorder_pushing.fetch_add(1);
+    SessionRecorder* recorder = camera->recorder.load();
+    if (recorder != nullptr) {
+        recorder->push(frame);
+    }
+    camera->recorder_pushing.fetch_sub(1, std::memory_order_release);
+    camera->buffer->push(std::move(frame));
+    if (camera->event_fd >= 0) {
+        uint64_t count = 1;
+        ssize_t ret = write(camera->event_fd, &count, sizeof(count));
+        (void)ret;
+    }
+}
+
+// 替换录制器后等待仍持有旧指针的推帧返回，之后旧录制器可以关闭或销毁
+void rm::setCameraRecorder(Camera *camera, SessionRecorder *recorder) {
+    if (camera == nullptr) {
+        rm::message("Video event error at nullptr camera", rm::MSG_ERROR);
+        return;
+    }
+    camera->recorder.exchange(recorder);
+    while (camera->recorder_pushing.load() != 0) std::this_thread::yield();
+}
+
+// 创建监听多个相机的epoll，事件数据高32位为相机在cameras中的下标，低32位为eventfd
+int rm::createCameraEpoll(const std::vector<Camera*>& cameras) {
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0) {
+        rm::message("Video event error creating epoll", rm::MSG_ERROR);
+        return -1;
+    }
+
+    for (size_t i = 0; i < cameras.size(); i++) {
+        if (!openCameraEvent(cameras[i])) {
+            close(epoll_fd);
+            return -1;
+        }
+        struct epoll_event event;
+        event.events = EPOLLIN;
+        event.data.u64 = (static_cast<uint64_t>(i) << 32) | static_cast<uint32_t>(cameras[i]->event_fd);
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, cameras[i]->event_fd, &event) < 0) {
+            rm::message("Video event error adding camera: " + std::to_string(cameras[i]->camera_id), rm::MSG_ERROR);
+            close(epoll_fd);
+            return -1;
+        }
+    }
+    return epoll_fd;
+}
+
+// 阻塞至至少一个相机有新帧，ready_list 返回有新帧的相机下标
+// 通知与帧缓冲区不是原子的，此后 pop 仍可能返回 nullptr
+bool rm::waitCameraEpoll(int epoll_fd, std::vector<int>& ready_list, int timeout_ms) {
+    ready_list.clear();
+
+    struct epoll_event events[32];
+    int num = epoll_wait(epoll_fd, events, 32, timeout_ms);
+    if (num < 0) {
+        if (errno != EINTR) {
+            rm::message("Video event error waiting epoll", rm::MSG_ERROR);
+        }
+        return false;
+    }
+
+    for (int i = 0; i < num; i++) {
+        // 清空eventfd计数，避免水平触发下重复唤醒
+        int event_fd = static_cast<int>(events[i].data.u64 & 0xFFFFFFFFull);
+        uint64_t count;
+        ssize_t ret = read(event_fd, &count, sizeof(count));
+        (void)ret;
+        ready_list.push_back(static_cast<int>(events[i].data.u64 >> 32));
+    }
+    return num > 0;
+}
+
+void rm::closeCameraEpoll(int epoll_fd) {
+    if (epoll_fd >= 0) close(epoll_fd);
+}
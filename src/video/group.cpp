@@ -0,0 +1,177 @@
+#include "video/group.h"
+#include "video/video.h"
+#include "uniterm/uniterm.h"
+#include "utils/timer.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace rm;
+using namespace std;
+
+static double time_diff_ms(const TimePoint& a, const TimePoint& b) {
+    return getDoubleOfS(b, a) * 1e3;
+}
+
+bool CameraGroup::addCamera(Camera* camera) {
+    if (camera == nullptr || camera->buffer == nullptr) {
+        rm::message("Video group error at camera not opened", rm::MSG_ERROR);
+        return false;
+    }
+    if (running_) {
+        rm::message("Video group error at adding camera while running", rm::MSG_ERROR);
+        return false;
+    }
+    cameras_.push_back(camera);
+    pending_.emplace_back();
+    counters_.emplace_back(new Counter());
+    return true;
+}
+
+bool CameraGroup::start() {
+    if (running_) return true;
+    if (cameras_.empty()) {
+        rm::message("Video group error at empty group", rm::MSG_ERROR);
+        return false;
+    }
+
+    epoll_fd_ = rm::createCameraEpoll(cameras_);
+    if (epoll_fd_ < 0) return false;
+
+    running_ = true;
+    sync_thread_ = thread(&CameraGroup::sync, this);
+    rm::message("Video group start: " + to_string(cameras_.size()) + " cameras", rm::MSG_OK);
+    return true;
+}
+
+void CameraGroup::stop() {
+    if (!running_.exchange(false)) return;
+    if (sync_thread_.joinable()) sync_thread_.join();
+
+    // 相机须在 stop 之后才关闭，此时缓冲区仍然有效
+    for (size_t i = 0; i < cameras_.size(); i++) updateOverwrite(i);
+    rm::closeCameraEpoll(epoll_fd_);
+    epoll_fd_ = -1;
+    for (auto& pending : pending_) pending.clear();
+    rm::message("Video group stop", rm::MSG_WARNING);
+}
+
+CameraGroupStat CameraGroup::getStat(size_t index) const {
+    CameraGroupStat stat = {0, 0, 0, 0, 0.0};
+    if (index >= cameras_.size()) return stat;
+
+    const Counter& counter = *counters_[index];
+    stat.receive_num = counter.receive.load(memory_order_relaxed);
+    stat.bundle_num = counter.bundle.load(memory_order_relaxed);
+    stat.drop_num = counter.drop.load(memory_order_relaxed);
+    stat.overwrite_num = counter.overwrite.load(memory_order_relaxed);
+
+    uint64_t total = stat.receive_num + stat.overwrite_num;
+    if (total > 0) {
+        stat.drop_rate = static_cast<double>(stat.drop_num + stat.overwrite_num) / total;
+    }
+    return stat;
+}
+
+void CameraGroup::sync() {
+    vector<int> ready_list;
+    while (running_) {
+        if (!rm::waitCameraEpoll(epoll_fd_, ready_list, 100)) continue;
+
+        for (int i : ready_list) {
+            shared_ptr<Frame> frame = cameras_[i]->buffer->pop();
+            updateOverwrite(i);
+            if (frame == nullptr) continue;
+            counters_[i]->receive.fetch_add(1, memory_order_relaxed);
+
+            pending_[i].push_back(std::move(frame));
+            if (pending_[i].size() > history_) dropFront(i);
+        }
+        match();
+    }
+}
+
+// 相机缓冲区只在同步线程与 stop 中访问，getStat 只读取这里缓存的计数
+void CameraGroup::updateOverwrite(size_t index) {
+    counters_[index]->overwrite.store(cameras_[index]->buffer->getOverwriteCount(), memory_order_relaxed);
+}
+
+void CameraGroup::dropFront(size_t index) {
+    pending_[index].pop_front();
+    counters_[index]->drop.fetch_add(1, memory_order_relaxed);
+}
+
+// 以各相机最新帧中最早的时刻为参考，在每个相机中取与之最近的帧
+// 全部落在容差内则组成帧组，否则丢弃已不可能再被匹配的旧帧后重试
+void CameraGroup::match() {
+    const size_t num = cameras_.size();
+    vector<size_t> nearest(num);
+
+    while (true) {
+        for (size_t i = 0; i < num; i++) {
+            if (pending_[i].empty()) return;
+        }
+
+        TimePoint reference = pending_[0].back()->time_point;
+        TimePoint latest_front = pending_[0].front()->time_point;
+        for (size_t i = 1; i < num; i++) {
+            reference = min(reference, pending_[i].back()->time_point);
+            latest_front = max(latest_front, pending_[i].front()->time_point);
+        }
+
+        bool matched = true;
+        for (size_t i = 0; i < num && matched; i++) {
+            double best = 1e18;
+            for (size_t k = 0; k < pending_[i].size(); k++) {
+                double diff = abs(time_diff_ms(pending_[i][k]->time_point, reference));
+                if (diff < best) {
+                    best = diff;
+                    nearest[i] = k;
+                }
+            }
+            if (best > tolerance_ms_) matched = false;
+        }
+
+        if (!matched) {
+            // 某相机最早的帧晚于 latest_front，比 latest_front 早出容差的帧已不可能匹配
+            bool dropped = false;
+            for (size_t i = 0; i < num; i++) {
+                while (!pending_[i].empty() && time_diff_ms(latest_front, pending_[i].front()->time_point) > tolerance_ms_) {
+                    dropFront(i);
+                    dropped = true;
+                }
+            }
+
+            // 无帧可判定为过期时，丢弃全局最早的一帧以保证前进
+            if (!dropped) {
+                size_t oldest = 0;
+                for (size_t i = 1; i < num; i++) {
+                    if (pending_[i].front()->time_point < pending_[oldest].front()->time_point) oldest = i;
+                }
+                dropFront(oldest);
+            }
+            continue;
+        }
+
+        shared_ptr<FrameBundle> bundle = make_shared<FrameBundle>();
+        bundle->time_point = reference;
+        bundle->frames.resize(num);
+
+        TimePoint earliest = pending_[0][nearest[0]]->time_point;
+        TimePoint latest = earliest;
+        for (size_t i = 0; i < num; i++) {
+            // 被选中帧之前的帧不会再被使用
+            for (size_t k = 0; k < nearest[i]; k++) dropFront(i);
+            bundle->frames[i] = std::move(pending_[i].front());
+            pending_[i].pop_front();
+            counters_[i]->bundle.fetch_add(1, memory_order_relaxed);
+
+            earliest = min(earliest, bundle->frames[i]->time_point);
+            latest = max(latest, bundle->frames[i]->time_point);
+        }
+        bundle->skew_ms = time_diff_ms(latest, earliest);
+        skew_hist_.record(bundle->skew_ms * 1e3);
+        bundle_count_.fetch_add(1, memory_order_relaxed);
+
+        bundles.push(bundle);
+    }
+}
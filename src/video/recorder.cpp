@@ -0,0 +1,233 @@
+#include "video/recorder.h"
+#include "uniterm/uniterm.h"
+#include "utils/timer.h"
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <fcntl.h>
+#include <errno.h>
+#include <unistd.h>
+
+#ifdef OPENRM_WITH_LZ4
+#include <lz4.h>
+#endif
+
+using namespace rm;
+using namespace std;
+
+bool SessionRecorder::open(const std::string& file_name, bool compress, size_t queue_size) {
+    if (isOpen()) {
+        rm::message("Video recorder error at already opened", rm::MSG_ERROR);
+        return false;
+    }
+
+    // 优先绕过页缓存直接写盘，文件系统不支持 O_DIRECT 时退回普通写入
+    fd_ = ::open(file_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC | O_DIRECT, 0644);
+    if (fd_ < 0 && errno == EINVAL) {
+        fd_ = ::open(file_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    }
+    if (fd_ < 0) {
+        rm::message("Video recorder error opening: " + file_name, rm::MSG_ERROR);
+        return false;
+    }
+
+#ifdef OPENRM_WITH_LZ4
+    compress_ = compress;
+#else
+    if (compress) {
+        rm::message("Video recorder built without lz4, compression disabled", rm::MSG_WARNING);
+    }
+    compress_ = false;
+#endif
+
+    if (!reserveStaging(SESSION_ALIGN)) {
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+
+    // 文件头独占第一个对齐块
+    SessionHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = SESSION_MAGIC;
+    header.version = SESSION_VERSION;
+    header.align = SESSION_ALIGN;
+    header.create_time = transTimeToUll(getTime());
+    memset(staging_, 0, SESSION_ALIGN);
+    memcpy(staging_, &header, sizeof(header));
+
+    offset_ = 0;
+    if (!writeAligned(staging_, SESSION_ALIGN)) {
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+
+    queue_.assign(std::max(queue_size, (size_t)1) + 1, nullptr);
+    head_.store(0);
+    tail_.store(0);
+    stopping_.store(false);
+    write_count_.store(0);
+    drop_count_.store(0);
+    write_bytes_.store(SESSION_ALIGN);
+
+    running_.store(true, std::memory_order_release);
+    writer_thread_ = std::thread(&SessionRecorder::writer, this);
+    rm::message("Video recorder opened: " + file_name, rm::MSG_OK);
+    return true;
+}
+
+void SessionRecorder::close() {
+    if (!running_.exchange(false)) return;
+
+    // 等待已通过运行标志检查的 push 完成入队，再通知写线程写完队列后退出
+    while (pushing_.load() != 0) std::this_thread::yield();
+    stopping_.store(true, std::memory_order_release);
+    wait_cond_.notify_all();
+    if (writer_thread_.joinable()) writer_thread_.join();
+
+    fdatasync(fd_);
+    ::close(fd_);
+    fd_ = -1;
+
+    free(staging_);
+    staging_ = nullptr;
+    staging_size_ = 0;
+    queue_.clear();
+
+    rm::message("Video recorder closed, write " + to_string(getWriteCount()) + " drop " + to_string(getDropCount()), rm::MSG_WARNING);
+}
+
+bool SessionRecorder::push(std::shared_ptr<Frame> frame) {
+    if (frame == nullptr || frame->image == nullptr) return false;
+
+    // 先登记再检查运行标志，与 close 中先清标志再等待登记归零配对（均为顺序一致），close 不会在入队途中释放队列
+    pushing_.fetch_add(1);
+    if (!running_.load()) {
+        pushing_.fetch_sub(1);
+        return false;
+    }
+
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    size_t next = (tail + 1) % queue_.size();
+    if (next == head_.load(std::memory_order_acquire)) {
+        drop_count_.fetch_add(1, std::memory_order_relaxed);
+        pushing_.fetch_sub(1, std::memory_order_release);
+        return false;
+    }
+    queue_[tail] = std::move(frame);
+    tail_.store(next, std::memory_order_release);
+
+    // 写线程带超时等待，这里无需持锁通知；通知后才撤销登记，close 返回后不会再访问 wait_cond_
+    wait_cond_.notify_one();
+    pushing_.fetch_sub(1, std::memory_order_release);
+    return true;
+}
+
+void SessionRecorder::writer() {
+    while (true) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            // 关闭时先写完队列中剩余的帧，看到 stopping_ 后重新读取 tail_，确认最后一次 push 的帧已写出
+            if (stopping_.load(std::memory_order_acquire)) {
+                if (head == tail_.load(std::memory_order_acquire)) break;
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(wait_mutex_);
+            wait_cond_.wait_for(lock, std::chrono::milliseconds(10));
+            continue;
+        }
+
+        std::shared_ptr<Frame> frame = std::move(queue_[head]);
+        head_.store((head + 1) % queue_.size(), std::memory_order_release);
+
+        if (writeFrame(*frame)) {
+            write_count_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+bool SessionRecorder::writeFrame(const Frame& frame) {
+    cv::Mat image = *(frame.image);
+    if (image.empty()) return false;
+    if (!image.isContinuous()) image = image.clone();
+    size_t raw_size = image.total() * image.elemSize();
+
+    size_t data_bound = raw_size;
+#ifdef OPENRM_WITH_LZ4
+    if (compress_) data_bound = std::max(raw_size, static_cast<size_t>(LZ4_compressBound(static_cast<int>(raw_size))));
+#endif
+    if (!reserveStaging(alignSession(sizeof(SessionRecord) + data_bound))) return false;
+
+    SessionRecord record;
+    memset(&record, 0, sizeof(record));
+    record.magic = SESSION_RECORD_MAGIC;
+    record.compression = SESSION_COMPRESSION_NONE;
+    record.raw_size = raw_size;
+    record.time_point = transTimeToUll(frame.time_point);
+    record.camera_id = frame.camera_id;
+    record.width = image.cols;
+    record.height = image.rows;
+    record.type = image.type();
+    record.yaw = frame.yaw;
+    record.pitch = frame.pitch;
+    record.roll = frame.roll;
+    record.locate = frame.locate;
+
+    uint8_t* data = staging_ + sizeof(SessionRecord);
+    size_t data_size = raw_size;
+
+#ifdef OPENRM_WITH_LZ4
+    if (compress_) {
+        int ret = LZ4_compress_default(
+            reinterpret_cast<const char*>(image.data), reinterpret_cast<char*>(data),
+            static_cast<int>(raw_size), static_cast<int>(staging_size_ - sizeof(SessionRecord)));
+        if (ret > 0 && static_cast<size_t>(ret) < raw_size) {
+            record.compression = SESSION_COMPRESSION_LZ4;
+            data_size = static_cast<size_t>(ret);
+        }
+    }
+#endif
+    if (record.compression == SESSION_COMPRESSION_NONE) {
+        memcpy(data, image.data, raw_size);
+    }
+
+    record.data_size = data_size;
+    record.record_size = alignSession(sizeof(SessionRecord) + data_size);
+    memcpy(staging_, &record, sizeof(record));
+    memset(data + data_size, 0, record.record_size - sizeof(SessionRecord) - data_size);
+
+    return writeAligned(staging_, record.record_size);
+}
+
+bool SessionRecorder::writeAligned(const uint8_t* data, size_t size) {
+    size_t written = 0;
+    while (written < size) {
+        ssize_t ret = pwrite(fd_, data + written, size - written, static_cast<off_t>(offset_ + written));
+        if (ret < 0) {
+            if (errno == EINTR) continue;
+            rm::message("Video recorder error writing", rm::MSG_ERROR);
+            return false;
+        }
+        written += static_cast<size_t>(ret);
+    }
+    offset_ += size;
+    write_bytes_.fetch_add(size, std::memory_order_relaxed);
+    return true;
+}
+
+bool SessionRecorder::reserveStaging(size_t size) {
+    if (size <= staging_size_) return true;
+    size = alignSession(size);
+
+    void* buffer = nullptr;
+    if (posix_memalign(&buffer, SESSION_ALIGN, size) != 0) {
+        rm::message("Video recorder error allocating staging buffer", rm::MSG_ERROR);
+        return false;
+    }
+    free(staging_);
+    staging_ = static_cast<uint8_t*>(buffer);
+    staging_size_ = size;
+    return true;
+}
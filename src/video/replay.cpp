@@ -0,0 +1,297 @@
+#include "video/video.h"
+#include "video/session.h"
+#include "uniterm/uniterm.h"
+#include "utils/timer.h"
+#include <opencv2/opencv.hpp>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <memory>
+#include <cstring>
+#include <cstdint>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#ifdef OPENRM_WITH_LZ4
+#include <lz4.h>
+#endif
+
+using namespace rm;
+using namespace std;
+
+struct ReplayContext {
+    uint8_t* data = nullptr;                                // 映射的文件内容
+    size_t size = 0;                                        // 文件大小
+    vector<uint64_t> offsets;                               // 每条记录在文件中的偏移
+
+    thread worker;                                          // 回放线程
+    atomic<bool> running{false};
+    atomic<bool> finished{false};
+};
+
+static map<Camera*, shared_ptr<ReplayContext>> replay_map;
+static mutex replay_mutex;
+
+static shared_ptr<ReplayContext> get_context(Camera* camera) {
+    lock_guard<mutex> lock(replay_mutex);
+    auto it = replay_map.find(camera);
+    if (it == replay_map.end()) return nullptr;
+    return it->second;
+}
+
+// 检查 offset 处的记录是否完整且自洽，所有尺寸都先与剩余字节数比较，避免加法回绕
+// 未压缩的记录由 load_image 直接拷贝 raw_size 字节，要求 data_size 与 raw_size 相等
+static bool is_record_valid(const uint8_t* data, uint64_t offset, uint64_t size) {
+    if (offset > size || size - offset < sizeof(SessionRecord)) return false;
+    const SessionRecord* record = reinterpret_cast<const SessionRecord*>(data + offset);
+    uint64_t remain = size - offset;
+
+    if (record->magic != SESSION_RECORD_MAGIC) return false;
+    if (record->record_size < sizeof(SessionRecord) || record->record_size > remain) return false;
+    if (record->data_size > record->record_size - sizeof(SessionRecord)) return false;
+    if (record->width <= 0 || record->height <= 0) return false;
+    if (record->compression == SESSION_COMPRESSION_NONE && record->data_size != record->raw_size) return false;
+    if (record->compression == SESSION_COMPRESSION_LZ4 &&
+        (record->data_size > INT32_MAX || record->raw_size > INT32_MAX)) return false;
+    return true;
+}
+
+// 检查记录的图像类型与尺寸，load_image 据此分配图像，损坏的类型会让 cv::Mat::create 抛出异常
+static bool is_record_image_valid(const SessionRecord& record) {
+    if (record.type < 0 || (record.type & ~CV_MAT_TYPE_MASK) != 0) return false;
+    if (CV_MAT_DEPTH(record.type) > CV_16F || CV_MAT_CN(record.type) > CV_CN_MAX) return false;
+
+    // 行字节数不超过 2^31 * 2^12，按行相除避免乘法溢出
+    uint64_t row_size = static_cast<uint64_t>(record.width) * CV_ELEM_SIZE(record.type);
+    return record.raw_size % row_size == 0 && record.raw_size / row_size == static_cast<uint64_t>(record.height);
+}
+
+// 将记录中的图像数据还原到 image，尺寸或类型不符时重新分配
+static bool load_image(const SessionRecord& record, const uint8_t* data, cv::Mat& image) {
+    if (image.rows != record.height || image.cols != record.width || image.type() != record.type) {
+        image.create(record.height, record.width, record.type);
+    }
+    size_t image_size = image.total() * image.elemSize();
+    if (image_size != record.raw_size) {
+        rm::message("Video replay error at image size", rm::MSG_ERROR);
+        return false;
+    }
+
+    if (record.compression == SESSION_COMPRESSION_NONE) {
+        memcpy(image.data, data, image_size);
+        return true;
+    }
+#ifdef OPENRM_WITH_LZ4
+    if (record.compression == SESSION_COMPRESSION_LZ4) {
+        int ret = LZ4_decompress_safe(
+            reinterpret_cast<const char*>(data), reinterpret_cast<char*>(image.data),
+            static_cast<int>(record.data_size), static_cast<int>(image_size));
+        return ret == static_cast<int>(image_size);
+    }
+#endif
+    rm::message("Video replay error at unsupported compression", rm::MSG_ERROR);
+    return false;
+}
+
+static void replay_thread(Camera* camera, shared_ptr<ReplayContext> context, ReplaySpeed speed, double fps, bool loop) {
+    const SessionRecord* first = reinterpret_cast<const SessionRecord*>(context->data + context->offsets.front());
+    TimePoint first_time = transUlltoTime(first->time_point);
+    Duration_s period(fps > 0 ? 1.0 / fps : 0.0);
+
+    // 循环回放时每一轮的时间戳整体后移，保证时间戳单调递增
+    const SessionRecord* last = reinterpret_cast<const SessionRecord*>(context->data + context->offsets.back());
+    TimePoint::duration session_span = transUlltoTime(last->time_point) - first_time;
+    if (context->offsets.size() > 1) {
+        session_span += session_span / static_cast<int64_t>(context->offsets.size() - 1);
+    }
+    TimePoint::duration time_offset(0);
+
+    do {
+        TimePoint start_time = getTime();
+        for (size_t i = 0; i < context->offsets.size() && context->running; i++) {
+            const SessionRecord* record = reinterpret_cast<const SessionRecord*>(context->data + context->offsets[i]);
+            TimePoint record_time = transUlltoTime(record->time_point);
+
+            // 实时模式按录制时的帧间隔回放，定频模式按给定帧率回放
+            // 最快模式等待消费者取走上一帧后立即推入下一帧，保证每一帧都被处理
+            if (speed == REPLAY_SPEED_REALTIME) {
+                this_thread::sleep_until(start_time + (record_time - first_time));
+            } else if (speed == REPLAY_SPEED_FIXED) {
+                this_thread::sleep_until(start_time + chrono::duration_cast<TimePoint::duration>(period * static_cast<double>(i)));
+            } else {
+                while (camera->buffer->available() && context->running) {
+                    this_thread::sleep_for(chrono::microseconds(50));
+                }
+            }
+
+            shared_ptr<Frame> frame = camera->frame_pool->acquire();
+            const uint8_t* data = reinterpret_cast<const uint8_t*>(record) + sizeof(SessionRecord);
+            if (!load_image(*record, data, *(frame->image))) continue;
+
+            // 保留录制时的时间戳，使解算与滤波得到与实机一致的时间间隔
+            frame->time_point = record_time + time_offset;
+            frame->camera_id = record->camera_id;
+            frame->width = record->width;
+            frame->height = record->height;
+            frame->yaw = record->yaw;
+            frame->pitch = record->pitch;
+            frame->roll = record->roll;
+            frame->locate = record->locate;
+
+            rm::pushCameraFrame(camera, frame);
+        }
+        time_offset += session_span;
+    } while (loop && context->running);
+
+    // 先置完成标志再清运行标志，runReplay 看到未运行时即可回收本线程并重新开始
+    context->finished = true;
+    context->running = false;
+}
+
+bool rm::openReplay(Camera *camera, std::string file_name) {
+    if (camera == nullptr) {
+        rm::message("Video replay error at nullptr camera", rm::MSG_ERROR);
+        return false;
+    }
+    if (get_context(camera) != nullptr) {
+        rm::message("Video replay error at camera already opened", rm::MSG_ERROR);
+        return false;
+    }
+
+    int fd = open(file_name.c_str(), O_RDONLY);
+    if (fd < 0) {
+        rm::message("Video replay error opening: " + file_name, rm::MSG_ERROR);
+        return false;
+    }
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) < 0 || static_cast<size_t>(file_stat.st_size) < SESSION_ALIGN) {
+        rm::message("Video replay error at file size: " + file_name, rm::MSG_ERROR);
+        close(fd);
+        return false;
+    }
+
+    shared_ptr<ReplayContext> context = make_shared<ReplayContext>();
+    context->size = static_cast<size_t>(file_stat.st_size);
+    void* addr = mmap(NULL, context->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        rm::message("Video replay error mmap: " + file_name, rm::MSG_ERROR);
+        return false;
+    }
+    context->data = static_cast<uint8_t*>(addr);
+    madvise(addr, context->size, MADV_SEQUENTIAL);
+
+    const SessionHeader* header = reinterpret_cast<const SessionHeader*>(context->data);
+    if (header->magic != SESSION_MAGIC || header->version != SESSION_VERSION || header->align != SESSION_ALIGN) {
+        rm::message("Video replay error at session header: " + file_name, rm::MSG_ERROR);
+        munmap(context->data, context->size);
+        return false;
+    }
+
+    // 建立记录索引，遇到填充、截断或尺寸不自洽的记录即停止，图像类型或尺寸损坏的记录跳过
+    uint64_t offset = SESSION_ALIGN;
+    size_t drop_num = 0;
+    while (is_record_valid(context->data, offset, context->size)) {
+        const SessionRecord* record = reinterpret_cast<const SessionRecord*>(context->data + offset);
+        if (is_record_image_valid(*record)) {
+            context->offsets.push_back(offset);
+        } else {
+            drop_num++;
+        }
+        offset += record->record_size;
+    }
+    if (drop_num > 0) {
+        rm::message("Video replay drop " + to_string(drop_num) + " invalid records: " + file_name, rm::MSG_WARNING);
+    }
+    if (context->offsets.empty()) {
+        rm::message("Video replay error at empty session: " + file_name, rm::MSG_ERROR);
+        munmap(context->data, context->size);
+        return false;
+    }
+
+    // 以第一帧设置Camera参数
+    const SessionRecord* first = reinterpret_cast<const SessionRecord*>(context->data + context->offsets.front());
+    camera->width = first->width;
+    camera->height = first->height;
+    camera->camera_id = first->camera_id;
+    if (camera->buffer != nullptr) {
+        delete camera->buffer;
+    }
+    camera->buffer = new rm::SwapBuffer<rm::Frame>();
+    rm::openCameraEvent(camera);
+    if (camera->frame_pool != nullptr) {
+        delete camera->frame_pool;
+    }
+    camera->frame_pool = new rm::FramePool(first->width, first->height, first->type);
+
+    {
+        lock_guard<mutex> lock(replay_mutex);
+        replay_map[camera] = context;
+    }
+    rm::message("Video replay opened: " + file_name + " (" + to_string(context->offsets.size()) + " frames)", rm::MSG_OK);
+    return true;
+}
+
+bool rm::runReplay(Camera *camera, ReplaySpeed speed, double fps, bool loop) {
+    shared_ptr<ReplayContext> context = get_context(camera);
+    if (context == nullptr) {
+        rm::message("Video replay error at camera not opened", rm::MSG_ERROR);
+        return false;
+    }
+    if (context->running) {
+        return true;
+    }
+    if (speed == REPLAY_SPEED_FIXED && fps <= 0) {
+        rm::message("Video replay error at fixed speed without fps", rm::MSG_ERROR);
+        return false;
+    }
+
+    // 上一次回放已自然结束，回收其线程
+    if (context->worker.joinable()) {
+        context->worker.join();
+    }
+
+    context->running = true;
+    context->finished = false;
+    context->worker = thread(&replay_thread, camera, context, speed, fps, loop);
+    rm::message("Video replay start: " + to_string(camera->camera_id), rm::MSG_OK);
+    return true;
+}
+
+bool rm::isReplayFinished(Camera *camera) {
+    shared_ptr<ReplayContext> context = get_context(camera);
+    if (context == nullptr) return true;
+    return context->finished;
+}
+
+bool rm::closeReplay(Camera *camera) {
+    shared_ptr<ReplayContext> context;
+    {
+        lock_guard<mutex> lock(replay_mutex);
+        auto it = replay_map.find(camera);
+        if (it == replay_map.end()) {
+            rm::message("Video replay error at camera not opened", rm::MSG_ERROR);
+            return false;
+        }
+        context = it->second;
+        replay_map.erase(it);
+    }
+
+    context->running = false;
+    if (context->worker.joinable()) {
+        context->worker.join();
+    }
+    munmap(context->data, context->size);
+
+    delete camera->buffer;
+    camera->buffer = nullptr;
+    delete camera->frame_pool;
+    camera->frame_pool = nullptr;
+
+    rm::message("Video replay closed: " + to_string(camera->camera_id), rm::MSG_WARNING);
+    return true;
+}
@@ -2,3 +2,12 @@
 #include "structure/camera.hpp"
 #include "uniterm/uniterm.h"
 #include "video/video.h"
+
+bool rm::getExposurePose(Camera *camera, const TimePoint& exposure_start, PoseStamp& pose) {
+    if (camera == nullptr || camera->pose_ring == nullptr) {
+        return false;
+    }
+    std::chrono::duration<double, std::micro> half_exposure(camera->exposure_us / 2.0);
+    TimePoint exposure_mid = exposure_start + std::chrono::duration_cast<TimePoint::duration>(half_exposure);
+    return camera->pose_ring->query(exposure_mid, pose);
+}
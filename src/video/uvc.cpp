@@ -8,102 +8,306 @@
 #include <fcntl.h>
 #include <errno.h>
 #include <sys/ioctl.h>
+#include <poll.h>
 #include <unistd.h>
 #include <linux/videodev2.h>
 #include <sys/mman.h>
 #include <opencv2/opencv.hpp>
 #include <cstdint>
+#include <algorithm>
 #include <thread>
 #include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+
+// 默认的设备操作，直接调用系统接口
+static int default_open(const char* name, int flags) { return open(name, flags); }
+static int default_close(int fd) { return close(fd); }
+static int default_ioctl(int fd, unsigned long request, void* arg) { return ioctl(fd, request, arg); }
+static int default_poll(struct pollfd* fds, nfds_t nfds, int timeout) { return poll(fds, nfds, timeout); }
+static void* default_mmap(void* addr, size_t length, int prot, int flags, int fd, off_t offset) {
+    return mmap(addr, length, prot, flags, fd, offset);
+}
+static int default_munmap(void* addr, size_t length) { return munmap(addr, length); }
+
+static const rm::UVCDeviceOps DEFAULT_DEVICE_OPS = {
+    default_open, default_close, default_ioctl, default_poll, default_mmap, default_munmap
+};
+static std::atomic<const rm::UVCDeviceOps*> device_ops(&DEFAULT_DEVICE_OPS);
+
+void rm::setUVCDeviceOps(const UVCDeviceOps* ops) {
+    device_ops.store((ops != nullptr) ? ops : &DEFAULT_DEVICE_OPS, std::memory_order_release);
+}
+
+static inline const rm::UVCDeviceOps* uvc_ops() { return device_ops.load(std::memory_order_acquire); }
+static inline int uvc_open(const char* name, int flags) { return uvc_ops()->open_device(name, flags); }
+static inline int uvc_close(int fd) { return uvc_ops()->close_device(fd); }
+static inline int uvc_ioctl(int fd, unsigned long request, void* arg) { return uvc_ops()->ioctl_device(fd, request, arg); }
+static inline int uvc_poll(struct pollfd* fds, nfds_t nfds, int timeout) { return uvc_ops()->poll_device(fds, nfds, timeout); }
+static inline void* uvc_mmap(void* addr, size_t length, int prot, int flags, int fd, off_t offset) {
+    return uvc_ops()->mmap_buffer(addr, length, prot, flags, fd, offset);
+}
+static inline int uvc_munmap(void* addr, size_t length) { return uvc_ops()->munmap_buffer(addr, length); }
+
+// ITU-R BT.601 定点系数，与 OpenCV COLOR_YUV2BGR_YUYV 的整数实现一致
+static const int YUV_SHIFT = 20;
+static const int YUV_CY  =  1220542;
+static const int YUV_CUB =  2116026;
+static const int YUV_CUG = -409993;
+static const int YUV_CVG = -852492;
+static const int YUV_CVR =  1673527;
+
+static inline void yuv_to_bgr(int y, int u, int v, uint8_t* dst) {
+    int yy = std::max(0, y - 16) * YUV_CY;
+    int round = 1 << (YUV_SHIFT - 1);
+    u -= 128;
+    v -= 128;
+    dst[0] = cv::saturate_cast<uint8_t>((yy + YUV_CUB * u + round) >> YUV_SHIFT);
+    dst[1] = cv::saturate_cast<uint8_t>((yy + YUV_CUG * u + YUV_CVG * v + round) >> YUV_SHIFT);
+    dst[2] = cv::saturate_cast<uint8_t>((yy + YUV_CVR * v + round) >> YUV_SHIFT);
+}
+
+// 半分辨率BGR：隔行取源图，每个YUYV宏像素(Y0 U Y1 V)输出一个像素，亮度取两点均值
+static void yuyv_to_bgr_half(const cv::Mat& src, cv::Mat& dst) {
+    cv::parallel_for_(cv::Range(0, dst.rows), [&](const cv::Range& range) {
+        for (int row = range.start; row < range.end; row++) {
+            const uint8_t* src_ptr = src.ptr<uint8_t>(row * 2);
+            uint8_t* dst_ptr = dst.ptr<uint8_t>(row);
+            for (int col = 0; col < dst.cols; col++) {
+                const uint8_t* yuyv = src_ptr + col * 4;
+                int y = (yuyv[0] + yuyv[2] + 1) >> 1;
+                yuv_to_bgr(y, yuyv[1], yuyv[3], dst_ptr + col * 3);
+            }
+        }
+    });
+}
+
+// 将内核缓冲区中的YUYV数据直接转换到目标图像，dst 需已按输出格式分配
+static bool yuyv_convert(const cv::Mat& src, cv::Mat& dst, rm::CaptureFormat format) {
+    try {
+        switch (format) {
+            case rm::CAPTURE_FORMAT_GRAY:
+                cv::cvtColor(src, dst, cv::COLOR_YUV2GRAY_YUYV);
+                break;
+            case rm::CAPTURE_FORMAT_BGR_HALF:
+                yuyv_to_bgr_half(src, dst);
+                break;
+            case rm::CAPTURE_FORMAT_BGR:
+            default:
+                cv::cvtColor(src, dst, cv::COLOR_YUV2BGR_YUYV);
+                break;
+        }
+    } catch (const cv::Exception& e) {
+        std::string error_msg = e.what();
+        rm::message("Video UVC: cvt error at" + error_msg, rm::MSG_ERROR);
+        return false;
+    } catch (...) {
+        rm::message("Video UVC: cvt error", rm::MSG_ERROR);
+        return false;
+    }
+    return true;
+}
 
-static void capture_thread(rm::Camera* camera, rm::Locate* locate_ptr, int fps) {
-    int delay = 1000.0 / static_cast<double>(fps);
-    TimePoint last_time = getTime();
-    while (true) {
-        int sleep_time = delay - static_cast<int>(getNumOfMs(last_time, getTime()));
-        if (sleep_time > 0) std::this_thread::sleep_for(std::chrono::milliseconds(sleep_time));
-        last_time = getTime();
+// MJPEG 解码到目标图像，半分辨率时由解码器直接按 1/2 缩放输出
+static bool mjpeg_decode(const cv::Mat& src, cv::Mat& dst, rm::CaptureFormat format) {
+    int flag = cv::IMREAD_COLOR;
+    if (format == rm::CAPTURE_FORMAT_GRAY) flag = cv::IMREAD_GRAYSCALE;
+    else if (format == rm::CAPTURE_FORMAT_BGR_HALF) flag = cv::IMREAD_REDUCED_COLOR_2;
+
+    try {
+        cv::imdecode(src, flag, &dst);
+    } catch (const cv::Exception& e) {
+        std::string error_msg = e.what();
+        rm::message("Video UVC: decode error at" + error_msg, rm::MSG_ERROR);
+        return false;
+    } catch (...) {
+        rm::message("Video UVC: decode error", rm::MSG_ERROR);
+        return false;
+    }
+    return !dst.empty();
+}
+
+static void requeue_buffer(rm::Camera* camera, struct v4l2_buffer& buffer) {
+    if (uvc_ioctl(camera->file_descriptor, VIDIOC_QBUF, &buffer) < 0) {
+        rm::message("Video UVC error requeue buffer", rm::MSG_ERROR);
+    }
+}
+
+// 多个解码线程的完成顺序不确定，只推入序号比上一次推入更新的帧
+struct DecodeOrder {
+    std::mutex mutex;
+    bool pushed = false;
+    uint32_t last_sequence = 0;
+};
+
+// 驱动时间戳为 CLOCK_MONOTONIC 时直接使用，否则退回出队时刻
+static TimePoint buffer_time(const struct v4l2_buffer& buffer) {
+    if ((buffer.flags & V4L2_BUF_FLAG_TIMESTAMP_MASK) != V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC) {
+        return getTime();
+    }
+    long long monotonic_ns = static_cast<long long>(buffer.timestamp.tv_sec) * 1000000000ll
+                           + static_cast<long long>(buffer.timestamp.tv_usec) * 1000ll;
+    return transMonotonicToTime(monotonic_ns);
+}
+
+// 驱动时间戳默认为帧结束时刻(TSTAMP_SRC_EOF 值为 0)，此时减去曝光时间；驱动声明为曝光开始时刻(SOE)时直接使用
+static TimePoint exposure_start(const rm::Camera* camera, const struct v4l2_buffer& buffer, const TimePoint& time_stamp) {
+    if ((buffer.flags & V4L2_BUF_FLAG_TSTAMP_SRC_MASK) == V4L2_BUF_FLAG_TSTAMP_SRC_EOF) {
+        std::chrono::duration<double, std::micro> exposure(camera->exposure_us);
+        return time_stamp - std::chrono::duration_cast<TimePoint::duration>(exposure);
+    }
+    return time_stamp;
+}
+
+static void record_latency(rm::Camera* camera, const TimePoint& time_stamp) {
+    camera->capture_latency.record(getDoubleOfS(time_stamp, getTime()) * 1e6);
+}
+
+static void capture_thread(rm::Camera* camera, rm::Locate* locate_ptr) {
+    std::shared_ptr<DecodeOrder> order = std::make_shared<DecodeOrder>();
+
+    struct pollfd poll_fd;
+    poll_fd.fd = camera->file_descriptor;
+    poll_fd.events = POLLIN;
+
+    bool has_last = false;
+    TimePoint last_stamp;
+    double last_interval = -1.0;
+
+    while (camera->capture_running.load(std::memory_order_acquire)) {
+        // 阻塞至驱动通知有填充完成的缓冲区，超时用于检查退出标志
+        int ret = uvc_poll(&poll_fd, 1, 100);
+        if (ret < 0 && errno != EINTR) {
+            rm::message("Video UVC error polling", rm::MSG_ERROR);
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            continue;
+        }
+        if (ret <= 0) continue;
+        if (poll_fd.revents & (POLLERR | POLLHUP | POLLNVAL)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            continue;
+        }
 
         struct v4l2_buffer buffer;
+        memset(&buffer, 0, sizeof(buffer));
         buffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-        if (ioctl(camera->file_descriptor, VIDIOC_DQBUF, &buffer) < 0) {
+        buffer.memory = V4L2_MEMORY_MMAP;
+        if (uvc_ioctl(camera->file_descriptor, VIDIOC_DQBUF, &buffer) < 0) {
             continue;
         }
 
-        TimePoint time_stamp = getTime();
-        rm::Locate locate;
-        if (locate_ptr != nullptr) {
-            locate = *(locate_ptr);
+        TimePoint time_stamp = buffer_time(buffer);
+
+        // 优先按曝光中点从位姿历史插值，未设置位姿历史时沿用外部 locate 指针
+        rm::PoseStamp pose{};
+        if (!rm::getExposurePose(camera, exposure_start(camera, buffer, time_stamp), pose) && locate_ptr != nullptr) {
+            pose.locate = *(locate_ptr);
         }
 
-        std::shared_ptr<rm::Frame> frame = std::make_shared<rm::Frame>();
-        cv::Mat image_yuv = cv::Mat(camera->height, camera->width, CV_8UC2, camera->capture_buffer[buffer.index]);
-        cv::Mat image_bgr;
-        
-        if (ioctl(camera->file_descriptor, VIDIOC_QBUF, &buffer) < 0) {
-            continue;
+        // 抖动为相邻两次帧间隔之差
+        if (has_last) {
+            double interval = getDoubleOfS(last_stamp, time_stamp) * 1e6;
+            if (last_interval >= 0) camera->capture_jitter.record(std::abs(interval - last_interval));
+            last_interval = interval;
         }
-        
-        try {
-            cv::cvtColor(image_yuv, image_bgr, cv::COLOR_YUV2BGR_YUYV);
-        } catch (const cv::Exception& e) {
-            std::string error_msg = e.what();
-            rm::message("Video UVC: cvt error at" + error_msg, rm::MSG_ERROR);
-            continue;
-        } catch (...) {
-            rm::message("Video UVC: cvt error", rm::MSG_ERROR);
+        has_last = true;
+        last_stamp = time_stamp;
+
+        if (camera->capture_pixel_format == rm::UVC_PIXEL_FORMAT_MJPEG) {
+            // 解码积压时丢弃该帧，避免延迟累积
+            if (camera->decode_pool->pending() >= camera->decode_pool->size()) {
+                requeue_buffer(camera, buffer);
+                continue;
+            }
+
+            std::shared_ptr<rm::Frame> frame = camera->frame_pool->acquire();
+            camera->decode_pool->post([camera, buffer, frame, time_stamp, pose, order]() mutable {
+                cv::Mat image_jpeg = cv::Mat(1, buffer.bytesused, CV_8UC1, camera->capture_buffer[buffer.index]);
+                bool decode_ok = mjpeg_decode(image_jpeg, *(frame->image), camera->capture_format);
+                requeue_buffer(camera, buffer);
+                if (!decode_ok) return;
+
+                frame->time_point = time_stamp;
+                frame->camera_id = camera->camera_id;
+                frame->width = frame->image->cols;
+                frame->height = frame->image->rows;
+                frame->locate = pose.locate;
+                frame->yaw = pose.yaw;
+                frame->pitch = pose.pitch;
+                frame->roll = pose.roll;
+
+                std::lock_guard<std::mutex> lock(order->mutex);
+                if (order->pushed && static_cast<int32_t>(buffer.sequence - order->last_sequence) <= 0) return;
+                order->pushed = true;
+                order->last_sequence = buffer.sequence;
+                rm::pushCameraFrame(camera, frame);
+                record_latency(camera, time_stamp);
+            });
             continue;
         }
 
+        // 持有出队的内核缓冲区，直接转换到帧池中预分配的图像内存，转换完成后再归还驱动
+        std::shared_ptr<rm::Frame> frame = camera->frame_pool->acquire();
+        cv::Mat image_yuv = cv::Mat(camera->height, camera->width, CV_8UC2, camera->capture_buffer[buffer.index]);
+        bool convert_ok = yuyv_convert(image_yuv, *(frame->image), camera->capture_format);
+        requeue_buffer(camera, buffer);
+        if (!convert_ok) continue;
+
         frame->time_point = time_stamp;
         frame->camera_id = camera->camera_id;
-        frame->width = camera->width;
-        frame->height = camera->height;
-        frame->locate = locate;
-        frame->image = std::make_shared<cv::Mat>(image_bgr);
+        frame->width = frame->image->cols;
+        frame->height = frame->image->rows;
+        frame->locate = pose.locate;
+        frame->yaw = pose.yaw;
+        frame->pitch = pose.pitch;
+        frame->roll = pose.roll;
         
-        camera->buffer->push(frame);
+        rm::pushCameraFrame(camera, frame);
+        record_latency(camera, time_stamp);
     }
 }
 
 bool rm::testUVC(std::string& device_name) {
     const char* name = device_name.c_str();
-    int fd = open(name, O_RDWR);
+    int fd = uvc_open(name, O_RDWR);
     if (fd == -1) {
         rm::message("Warning at opening camera: " + device_name, rm::MSG_WARNING);
-        close(fd);
+        uvc_close(fd);
         return false;
     }
 
     struct v4l2_capability cap;
-    if (ioctl(fd, VIDIOC_QUERYCAP, &cap) < 0) {
+    if (uvc_ioctl(fd, VIDIOC_QUERYCAP, &cap) < 0) {
         rm::message("Warning at querying camera: " + device_name, rm::MSG_WARNING);
-        close(fd);
+        uvc_close(fd);
         return false;
     }
 
     if (!(cap.capabilities & V4L2_CAP_VIDEO_CAPTURE)) {
         rm::message("The device does not handle video capture: " + device_name, rm::MSG_WARNING);
-        close(fd);
+        uvc_close(fd);
         return false;
     }
 
     if (!(cap.capabilities & V4L2_CAP_STREAMING)) {
         rm::message("The device does not handle streaming i/o: " + device_name, rm::MSG_WARNING);
-        close(fd);
+        uvc_close(fd);
         return false;
     }
 
     struct v4l2_fmtdesc fmtdesc;
     fmtdesc.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
     fmtdesc.index = 0;
-    if (ioctl(fd, VIDIOC_ENUM_FMT, &fmtdesc) < 0) {
+    if (uvc_ioctl(fd, VIDIOC_ENUM_FMT, &fmtdesc) < 0) {
         rm::message("Warning at querying camera format: " + device_name, rm::MSG_WARNING);
-        close(fd);
+        uvc_close(fd);
         return false;
     }
 
-    close(fd);
+    uvc_close(fd);
     return true;
 }
 
@@ -135,7 +339,79 @@ bool rm::listUVC(std::vector<std::string>& device_list, std::string base_name) {
 }
 
 
-bool rm::openUVC(Camera *camera, unsigned int width, unsigned int height, unsigned int fps, unsigned int buffer_num, std::string device_name) {
+// 解除前 num 个采集缓冲区的映射
+static void release_capture_buffer(rm::Camera* camera, uint32_t num) {
+    if (camera->capture_buffer != nullptr) {
+        for (uint32_t i = 0; i < num; i++) {
+            uvc_munmap(camera->capture_buffer[i], camera->capture_buffer_size[i]);
+        }
+    }
+    delete[] camera->capture_buffer;
+    delete[] camera->capture_buffer_size;
+    camera->capture_buffer = nullptr;
+    camera->capture_buffer_size = nullptr;
+}
+
+// 枚举驱动支持的帧间隔，选取与目标帧率最接近的一项
+static bool select_frame_interval(
+    int fd, uint32_t pixel_format, unsigned int width, unsigned int height, unsigned int fps,
+    struct v4l2_fract& interval
+) {
+    struct v4l2_frmivalenum frmival;
+    memset(&frmival, 0, sizeof(frmival));
+    frmival.pixel_format = pixel_format;
+    frmival.width = width;
+    frmival.height = height;
+
+    double target = 1.0 / static_cast<double>(std::max(fps, 1u));
+    double best_diff = 1e9;
+    bool found = false;
+
+    while (uvc_ioctl(fd, VIDIOC_ENUM_FRAMEINTERVALS, &frmival) == 0) {
+        if (frmival.type == V4L2_FRMIVAL_TYPE_DISCRETE) {
+            const struct v4l2_fract& fract = frmival.discrete;
+            if (fract.denominator != 0) {
+                double diff = std::abs(static_cast<double>(fract.numerator) / fract.denominator - target);
+                if (diff < best_diff) {
+                    best_diff = diff;
+                    interval = fract;
+                    found = true;
+                }
+            }
+            frmival.index++;
+            continue;
+        }
+
+        // 连续或步进型间隔只返回一项，目标在范围内则直接使用，否则取最近的边界
+        const struct v4l2_fract& min_fract = frmival.stepwise.min;
+        const struct v4l2_fract& max_fract = frmival.stepwise.max;
+        if (min_fract.denominator == 0 || max_fract.denominator == 0) break;
+        double min_t = static_cast<double>(min_fract.numerator) / min_fract.denominator;
+        double max_t = static_cast<double>(max_fract.numerator) / max_fract.denominator;
+        if (target < min_t) {
+            interval = min_fract;
+        } else if (target > max_t) {
+            interval = max_fract;
+        } else {
+            interval.numerator = 1;
+            interval.denominator = std::max(fps, 1u);
+        }
+        found = true;
+        break;
+    }
+    return found;
+}
+
+bool rm::openUVC(
+    Camera *camera,
+    unsigned int width,
+    unsigned int height,
+    unsigned int fps,
+    unsigned int buffer_num,
+    std::string device_name,
+    CaptureFormat capture_format,
+    UVCPixelFormat pixel_format
+) {
     if (camera == nullptr) {
         rm::message("Video UVC error at nullptr camera", rm::MSG_ERROR);
         return false;
@@ -144,46 +420,62 @@ bool rm::openUVC(Camera *camera, unsigned int width, unsigned int height, unsign
     
     // 打开视频设备文件
     const char* chname = device_name.c_str();
-    int fd = open(chname, O_RDWR);
+    int fd = uvc_open(chname, O_RDWR);
     if (fd == -1) {
         rm::message("Video UVC error opening: " + device_name, rm::MSG_ERROR);
-        close(fd);
+        uvc_close(fd);
         return false;
     }
 
     // 设置摄像头的参数
+    uint32_t v4l2_pixel_format = (pixel_format == UVC_PIXEL_FORMAT_MJPEG) ? V4L2_PIX_FMT_MJPEG : V4L2_PIX_FMT_YUYV;
     struct v4l2_format format = {0};
     format.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
     format.fmt.pix.width = width;
     format.fmt.pix.height = height;
-    format.fmt.pix.pixelformat = V4L2_PIX_FMT_YUYV;
-    if (ioctl(fd, VIDIOC_S_FMT, &format) < 0) {
+    format.fmt.pix.pixelformat = v4l2_pixel_format;
+    if (uvc_ioctl(fd, VIDIOC_S_FMT, &format) < 0) {
         rm::message("Video UVC error setting format: " + device_name, rm::MSG_ERROR);
-        close(fd);
+        uvc_close(fd);
+        return false;
+    }
+    if (format.fmt.pix.pixelformat != v4l2_pixel_format) {
+        rm::message("Video UVC error unsupported pixel format: " + device_name, rm::MSG_ERROR);
+        uvc_close(fd);
         return false;
     }
 
-    // 设置帧率
+    // 设置帧率，优先使用驱动枚举出的帧间隔，枚举失败时退回30/60
     struct v4l2_streamparm streamparam;
+    memset(&streamparam, 0, sizeof(streamparam));
     streamparam.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-    unsigned int denominator = (fps > 45u) ? 60u : 30u;
-    streamparam.parm.capture.timeperframe.numerator = 1;
-    streamparam.parm.capture.timeperframe.denominator = denominator;
-    if (ioctl(fd, VIDIOC_S_PARM, &streamparam) < 0) {
+    struct v4l2_fract interval;
+    if (!select_frame_interval(fd, v4l2_pixel_format, width, height, fps, interval)) {
+        interval.numerator = 1;
+        interval.denominator = (fps > 45u) ? 60u : 30u;
+    }
+    streamparam.parm.capture.timeperframe = interval;
+    if (uvc_ioctl(fd, VIDIOC_S_PARM, &streamparam) < 0) {
         rm::message("Video UVC error getting stream parameters: " + device_name, rm::MSG_ERROR);
-        close(fd);
+        uvc_close(fd);
         return false;
     }
+    const struct v4l2_fract& actual = streamparam.parm.capture.timeperframe;
+    if (actual.numerator != 0) {
+        rm::message("Video UVC fps: " + std::to_string(static_cast<double>(actual.denominator) / actual.numerator));
+    }
 
     // 申请内核空间
     camera->capture_buffer_num = std::clamp(buffer_num, 4u, 128u);
+    camera->capture_pixel_format = pixel_format;
     struct v4l2_requestbuffers requestbuffers;
+    memset(&requestbuffers, 0, sizeof(requestbuffers));
     requestbuffers.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
     requestbuffers.count = camera->capture_buffer_num;
     requestbuffers.memory = V4L2_MEMORY_MMAP;
-    if (ioctl(fd, VIDIOC_REQBUFS, &requestbuffers) < 0) {
+    if (uvc_ioctl(fd, VIDIOC_REQBUFS, &requestbuffers) < 0) {
         rm::message("Video UVC error requesting buffer: " + device_name, rm::MSG_ERROR);
-        close(fd);
+        uvc_close(fd);
         return false;
     }
 
@@ -191,29 +483,26 @@ bool rm::openUVC(Camera *camera, unsigned int width, unsigned int height, unsign
     camera->capture_buffer = new uint8_t*[camera->capture_buffer_num];
     camera->capture_buffer_size = new uint32_t[camera->capture_buffer_num];
     struct v4l2_buffer mapbuffer;
-    mapbuffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
 
     for(uint32_t i = 0; i < camera->capture_buffer_num; i++) {
+        memset(&mapbuffer, 0, sizeof(mapbuffer));
+        mapbuffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        mapbuffer.memory = V4L2_MEMORY_MMAP;
         mapbuffer.index = i;
-        if (ioctl(fd, VIDIOC_QUERYBUF, &mapbuffer) < 0) {
+
+        if (uvc_ioctl(fd, VIDIOC_QUERYBUF, &mapbuffer) < 0) {
             rm::message("Video UVC error querying buffer: " + device_name, rm::MSG_ERROR);
-            delete[] camera->capture_buffer;
-            delete[] camera->capture_buffer_size;
-            close(fd);
+            release_capture_buffer(camera, i);
+            uvc_close(fd);
             return false;
         }
-
-        camera->capture_buffer[i] = (uint8_t*)mmap(NULL, mapbuffer.length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, mapbuffer.m.offset);
+        camera->capture_buffer[i] = (uint8_t*)uvc_mmap(NULL, mapbuffer.length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, mapbuffer.m.offset);
         camera->capture_buffer_size[i] = mapbuffer.length;
 
-        if (ioctl(fd, VIDIOC_QBUF, &mapbuffer) < 0) {
+        if (uvc_ioctl(fd, VIDIOC_QBUF, &mapbuffer) < 0) {
             rm::message("Video UVC error mmap buffer: " + device_name, rm::MSG_ERROR);
-            for (uint32_t j = 0; j < i; j++) {
-                munmap(camera->capture_buffer[j], camera->capture_buffer_size[j]);
-            }
-            delete[] camera->capture_buffer;
-            delete[] camera->capture_buffer_size;
-            close(fd);
+            release_capture_buffer(camera, i + 1);
+            uvc_close(fd);
             return false;
         }
     }
@@ -226,6 +515,35 @@ bool rm::openUVC(Camera *camera, unsigned int width, unsigned int height, unsign
         delete camera->buffer;
     }
     camera->buffer = new rm::SwapBuffer<rm::Frame>();
+    rm::openCameraEvent(camera);
+    if (camera->frame_pool != nullptr) {
+        delete camera->frame_pool;
+    }
+
+    // 帧池按输出格式分配，检测模块可直接取用灰度或半分辨率图像，无需再次转换
+    camera->capture_format = capture_format;
+    switch (capture_format) {
+        case CAPTURE_FORMAT_GRAY:
+            camera->frame_pool = new rm::FramePool(camera->width, camera->height, CV_8UC1);
+            break;
+        case CAPTURE_FORMAT_BGR_HALF:
+            camera->frame_pool = new rm::FramePool(camera->width / 2, camera->height / 2, CV_8UC3);
+            break;
+        case CAPTURE_FORMAT_BGR:
+        default:
+            camera->frame_pool = new rm::FramePool(camera->width, camera->height, CV_8UC3);
+            break;
+    }
+
+    // MJPEG 解码耗时较长，交由线程池并行处理
+    if (camera->decode_pool != nullptr) {
+        delete camera->decode_pool;
+        camera->decode_pool = nullptr;
+    }
+    if (pixel_format == UVC_PIXEL_FORMAT_MJPEG) {
+        size_t thread_num = std::clamp(std::thread::hardware_concurrency() / 2u, 1u, 4u);
+        camera->decode_pool = new rm::ThreadPool(thread_num);
+    }
     
     int temp_id = 0;
     int start_index = device_name.length() - 1;
@@ -258,63 +576,65 @@ bool rm::setUVC(
     struct v4l2_control ctrl; 
     ctrl.id = V4L2_CID_EXPOSURE_AUTO;
     ctrl.value = V4L2_EXPOSURE_MANUAL;
-    if (ioctl(camera->file_descriptor, VIDIOC_S_CTRL, &ctrl) < 0) {
+    if (uvc_ioctl(camera->file_descriptor, VIDIOC_S_CTRL, &ctrl) < 0) {
         rm::message("Video UVC error setting exposure mode", rm::MSG_ERROR);
         return false;
     }
 
     ctrl.id = V4L2_CID_EXPOSURE_ABSOLUTE;
     ctrl.value = exposure;
-    if (ioctl(camera->file_descriptor, VIDIOC_S_CTRL, &ctrl) < 0) {
+    if (uvc_ioctl(camera->file_descriptor, VIDIOC_S_CTRL, &ctrl) < 0) {
         rm::message("Video UVC error setting exposure value", rm::MSG_ERROR);
         return false;
     }
+    // V4L2 绝对曝光的单位为 100 微秒
+    camera->exposure_us = static_cast<double>(exposure) * 100.0;
 
     ctrl.id = V4L2_CID_BRIGHTNESS;
     ctrl.value = brightness;
-    if (ioctl(camera->file_descriptor, VIDIOC_S_CTRL, &ctrl) < 0) {
+    if (uvc_ioctl(camera->file_descriptor, VIDIOC_S_CTRL, &ctrl) < 0) {
         rm::message("Video UVC error setting brightness", rm::MSG_ERROR);
         return false;
     }
 
     ctrl.id = V4L2_CID_CONTRAST;
     ctrl.value = contrast;
-    if (ioctl(camera->file_descriptor, VIDIOC_S_CTRL, &ctrl) < 0) {
+    if (uvc_ioctl(camera->file_descriptor, VIDIOC_S_CTRL, &ctrl) < 0) {
         rm::message("Video UVC error setting contrast", rm::MSG_ERROR);
         return false;
     }
 
     ctrl.id = V4L2_CID_GAMMA;
     ctrl.value = gamma;
-    if (ioctl(camera->file_descriptor, VIDIOC_S_CTRL, &ctrl) < 0) {
+    if (uvc_ioctl(camera->file_descriptor, VIDIOC_S_CTRL, &ctrl) < 0) {
         rm::message("Video UVC error setting gamma", rm::MSG_ERROR);
         return false;
     }
 
     ctrl.id = V4L2_CID_GAIN;
     ctrl.value = gain;
-    if (ioctl(camera->file_descriptor, VIDIOC_S_CTRL, &ctrl) < 0) {
+    if (uvc_ioctl(camera->file_descriptor, VIDIOC_S_CTRL, &ctrl) < 0) {
         rm::message("Video UVC error setting gain", rm::MSG_ERROR);
         return false;
     }
 
     ctrl.id = V4L2_CID_SHARPNESS;
     ctrl.value = sharpness;
-    if (ioctl(camera->file_descriptor, VIDIOC_S_CTRL, &ctrl) < 0) {
+    if (uvc_ioctl(camera->file_descriptor, VIDIOC_S_CTRL, &ctrl) < 0) {
         rm::message("Video UVC error setting sharpness", rm::MSG_ERROR);
         return false;
     }
 
     ctrl.id = V4L2_CID_BACKLIGHT_COMPENSATION;
     ctrl.value = backlight;
-    if (ioctl(camera->file_descriptor, VIDIOC_S_CTRL, &ctrl) < 0) {
+    if (uvc_ioctl(camera->file_descriptor, VIDIOC_S_CTRL, &ctrl) < 0) {
         rm::message("Video UVC error setting backlight", rm::MSG_ERROR);
         return false;
     }
 
     ctrl.id = V4L2_CID_AUTO_WHITE_BALANCE;
     ctrl.value = 1;
-    if (ioctl(camera->file_descriptor, VIDIOC_S_CTRL, &ctrl) < 0) {
+    if (uvc_ioctl(camera->file_descriptor, VIDIOC_S_CTRL, &ctrl) < 0) {
         rm::message("Video UVC error setting white balance mode", rm::MSG_ERROR);
         return false;
     }
@@ -327,17 +647,23 @@ bool rm::runUVC(Camera *camera, Locate* locate_ptr, int fps) {
         rm::message("Video UVC error at nullptr camera", rm::MSG_ERROR);
         return false;
     }
+    // 采集线程仍在运行时再次启动会覆盖可 join 的线程对象，须先调用 closeUVC
+    if (camera->capture_worker.joinable()) {
+        rm::message("Video UVC error at capture already running", rm::MSG_ERROR);
+        return false;
+    }
 
     // 开始采集
     int type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-    if (ioctl(camera->file_descriptor, VIDIOC_STREAMON, &type) < 0) {
+    if (uvc_ioctl(camera->file_descriptor, VIDIOC_STREAMON, &type) < 0) {
         rm::message("Video UVC error starting stream", rm::MSG_ERROR);
         return false;
     }
 
-    // 启动采集线程
-    std::thread capture(&capture_thread, camera, locate_ptr, fps);
-    capture.detach();
+    // 启动采集线程，帧节奏由驱动决定，fps 参数仅为保持接口兼容
+    (void)fps;
+    camera->capture_running.store(true, std::memory_order_release);
+    camera->capture_worker = std::thread(&capture_thread, camera, locate_ptr);
     rm::message("Video UVC start capture: " + std::to_string(camera->camera_id), rm::MSG_OK);
     return true;
 }
@@ -348,26 +674,32 @@ bool rm::closeUVC(Camera *camera) {
         return false;
     }
 
+    // 先等待采集线程退出，之后才可停止采集并释放其使用的缓冲区
+    camera->capture_running.store(false, std::memory_order_release);
+    if (camera->capture_worker.joinable()) {
+        camera->capture_worker.join();
+    }
+
+    // 等待排队与解码中的帧完成，这些任务会把缓冲区归还驱动，须在停止采集之前结束
+    delete camera->decode_pool;
+    camera->decode_pool = nullptr;
+
     // 停止采集
     int type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-    if (ioctl(camera->file_descriptor, VIDIOC_STREAMOFF, &type) < 0) {
+    if (uvc_ioctl(camera->file_descriptor, VIDIOC_STREAMOFF, &type) < 0) {
         rm::message("Video UVC error stopping stream", rm::MSG_ERROR);
         return false;
     }
 
     // 释放内核空间
-    for (uint32_t i = 0; i < camera->capture_buffer_num; i++) {
-        munmap(camera->capture_buffer[i], camera->capture_buffer_size[i]);
-    }
-    delete[] camera->capture_buffer;
-    delete[] camera->capture_buffer_size;
-    camera->capture_buffer = nullptr;
-    camera->capture_buffer_size = nullptr;
+    release_capture_buffer(camera, camera->capture_buffer_num);
 
     // 关闭设备
-    close(camera->file_descriptor);
+    uvc_close(camera->file_descriptor);
     delete camera->buffer;
     camera->buffer = nullptr;
+    delete camera->frame_pool;
+    camera->frame_pool = nullptr;
 
     rm::message("Video UVC closed: " + std::to_string(camera->camera_id), rm::MSG_WARNING);
     return true;